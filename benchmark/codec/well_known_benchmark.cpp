@@ -0,0 +1,185 @@
+// Microbenchmarks of the WKT and WKB codecs, run outside of DuckDB's
+// execution engine. Polygons range from 5 to 1M vertices, with and without a
+// hole. Besides the time per iteration, each benchmark reports:
+//   time_per_vertex: time per input/output vertex
+//   bytes_allocated: bytes allocated through operator new per iteration
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/types/string_type.hpp"
+#include "well_known_decoder.hpp"
+#include "well_known_encoder.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Bytes allocated on this thread, for the bytes_allocated counter
+static thread_local size_t allocatedBytes = 0;
+
+void *operator new(size_t size) {
+  allocatedBytes += size;
+  if (void *ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t size) noexcept { std::free(ptr); }
+
+namespace duckdb {
+
+using Ring = std::vector<std::pair<double, double>>;
+
+struct TestPolygon {
+  // Closed loops of (lng, lat) degrees, the first being the outer loop
+  std::vector<Ring> loops;
+  size_t numVerts = 0;
+};
+
+// A closed, slightly irregular ring of numVerts + 1 vertices
+static Ring MakeRing(size_t numVerts, double radius) {
+  Ring ring;
+  ring.reserve(numVerts + 1);
+  for (size_t i = 0; i < numVerts; i++) {
+    double angle = 2 * M_PI * i / numVerts;
+    double r = radius * (1 + 0.1 * std::sin(7 * angle));
+    ring.emplace_back(-122.4 + r * std::cos(angle),
+                      37.7 + r * std::sin(angle));
+  }
+  ring.push_back(ring.front());
+  return ring;
+}
+
+static TestPolygon MakePolygon(size_t numVerts, bool withHole) {
+  TestPolygon polygon;
+  size_t holeVerts = withHole ? std::max<size_t>(numVerts / 4, 3) : 0;
+  polygon.loops.push_back(
+      MakeRing(std::max<size_t>(numVerts - holeVerts, 3), 0.1));
+  if (withHole) {
+    polygon.loops.push_back(MakeRing(holeVerts, 0.02));
+  }
+  for (auto &loop : polygon.loops) {
+    polygon.numVerts += loop.size();
+  }
+  return polygon;
+}
+
+static std::string ToWkt(const TestPolygon &polygon) {
+  std::string wkt = "POLYGON (";
+  char point[64];
+  for (size_t i = 0; i < polygon.loops.size(); i++) {
+    wkt += i ? ", (" : "(";
+    for (size_t j = 0; j < polygon.loops[i].size(); j++) {
+      auto &vert = polygon.loops[i][j];
+      snprintf(point, sizeof(point), "%s%.15g %.15g", j ? ", " : "",
+               vert.first, vert.second);
+      wkt += point;
+    }
+    wkt += ")";
+  }
+  return wkt + ")";
+}
+
+template <typename T> static void AppendWkb(std::string &wkb, T value) {
+  wkb.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static std::string ToWkb(const TestPolygon &polygon) {
+  std::string wkb;
+  AppendWkb<uint8_t>(wkb, 1); // little endian
+  AppendWkb<uint32_t>(wkb, 3); // polygon
+  AppendWkb<uint32_t>(wkb, polygon.loops.size());
+  for (auto &loop : polygon.loops) {
+    AppendWkb<uint32_t>(wkb, loop.size());
+    for (auto &vert : loop) {
+      AppendWkb<double>(wkb, vert.first);
+      AppendWkb<double>(wkb, vert.second);
+    }
+  }
+  return wkb;
+}
+
+static void ReportCounters(benchmark::State &state, size_t numVerts,
+                           size_t bytes) {
+  state.counters["vertices"] = numVerts;
+  state.counters["time_per_vertex"] = benchmark::Counter(
+      numVerts, benchmark::Counter::kIsIterationInvariantRate |
+                    benchmark::Counter::kInvert);
+  state.counters["bytes_allocated"] =
+      benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+}
+
+template <PolygonDecodeStatus (*DECODE)(string_t, DecodedPolygons &)>
+static void RunDecode(benchmark::State &state, const std::string &encoded,
+                      size_t numVerts) {
+  string_t input(encoded.data(), encoded.size());
+  allocatedBytes = 0;
+  for (auto _ : state) {
+    DecodedPolygons decoded;
+    auto status = DECODE(input, decoded);
+    benchmark::DoNotOptimize(status);
+    benchmark::DoNotOptimize(decoded.polygons.data());
+  }
+  ReportCounters(state, numVerts, allocatedBytes);
+}
+
+static void BM_DecodeWkbPolygon(benchmark::State &state) {
+  auto polygon = MakePolygon(state.range(0), state.range(1));
+  RunDecode<DecodeWkbPolygon>(state, ToWkb(polygon), polygon.numVerts);
+}
+
+static void BM_DecodeWktPolygon(benchmark::State &state) {
+  auto polygon = MakePolygon(state.range(0), state.range(1));
+  RunDecode<DecodeWktPolygon>(state, ToWkt(polygon), polygon.numVerts);
+}
+
+// Encodes the polygon the way the extension does: a POLYGON when it has a
+// single loop, and otherwise a MULTIPOLYGON (as h3_cells_to_multi_polygon_*)
+template <typename ENCODER>
+static void BM_EncodePolygon(benchmark::State &state) {
+  auto polygon = MakePolygon(state.range(0), state.range(1));
+  allocatedBytes = 0;
+  for (auto _ : state) {
+    ENCODER enc;
+    if (polygon.loops.size() == 1) {
+      enc.StartPolygon();
+      for (auto &vert : polygon.loops[0]) {
+        enc.Point(vert.first, vert.second);
+      }
+      enc.EndPolygon();
+    } else {
+      enc.StartMultiPolygon(1);
+      enc.StartMultiPolygonPolygon(polygon.loops.size());
+      for (auto &loop : polygon.loops) {
+        enc.StartMultiPolygonLoop();
+        for (auto &vert : loop) {
+          enc.Point(vert.first, vert.second);
+        }
+        enc.EndMultiPolygonLoop();
+      }
+      enc.EndMultiPolygonPolygon();
+      enc.EndMultiPolygon();
+    }
+    auto encoded = enc.Finish();
+    benchmark::DoNotOptimize(encoded);
+  }
+  ReportCounters(state, polygon.numVerts, allocatedBytes);
+}
+
+// Vertex count (5 to 1M) and whether the polygon has a hole
+#define H3_CODEC_BENCHMARK(fn)                                                \
+  BENCHMARK(fn)->RangeMultiplier(10)->Ranges({{5, 1000000}, {0, 1}})
+
+H3_CODEC_BENCHMARK(BM_DecodeWkbPolygon);
+H3_CODEC_BENCHMARK(BM_DecodeWktPolygon);
+H3_CODEC_BENCHMARK(BM_EncodePolygon<WkbEncoder>);
+H3_CODEC_BENCHMARK(BM_EncodePolygon<WktEncoder>);
+
+} // namespace duckdb
+
+BENCHMARK_MAIN();
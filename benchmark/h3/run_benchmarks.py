@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Runs the H3 benchmarks with DuckDB's benchmark_runner.
+
+Prints the median time and rows/sec of each benchmark, and compares them
+against a stored baseline. The number of input rows of a benchmark is read
+from its "# rows:" comment.
+
+Run from the repository root, via `make bench` (or `make bench_baseline` to
+store a new baseline).
+"""
+
+import argparse
+import csv
+import os
+import re
+import statistics
+import subprocess
+import sys
+
+BENCHMARK_DIR = os.path.join("benchmark", "h3")
+
+
+def benchmark_path(name):
+    if name.endswith(".benchmark"):
+        return name
+    return os.path.join(BENCHMARK_DIR, name + ".benchmark")
+
+
+def read_rows(path):
+    with open(path) as f:
+        for line in f:
+            match = re.match(r"#\s*rows:\s*(\d+)", line)
+            if match:
+                return int(match.group(1))
+    return None
+
+
+def run(runner, pattern):
+    """Returns the timings of each benchmark, keyed by benchmark file."""
+    proc = subprocess.run(
+        [runner, pattern], stdout=subprocess.PIPE, universal_newlines=True
+    )
+    if proc.returncode != 0:
+        sys.exit("benchmark_runner failed with exit code %d" % proc.returncode)
+    timings = {}
+    # Result lines are "<benchmark>\t<run>\t<seconds>"
+    for line in proc.stdout.splitlines():
+        fields = line.strip().split("\t")
+        if len(fields) != 3:
+            continue
+        try:
+            seconds = float(fields[2])
+        except ValueError:
+            continue
+        timings.setdefault(benchmark_path(fields[0]), []).append(seconds)
+    return timings
+
+
+def summarize(timings):
+    results = {}
+    for path, runs in sorted(timings.items()):
+        median = statistics.median(runs)
+        rows = read_rows(path) if os.path.exists(path) else None
+        rows_per_second = rows / median if rows and median > 0 else None
+        results[path] = (median, rows_per_second)
+    return results
+
+
+def read_baseline(path):
+    baseline = {}
+    if not os.path.exists(path):
+        return baseline
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            baseline[row["benchmark"]] = float(row["median_seconds"])
+    return baseline
+
+
+def write_baseline(path, results):
+    with open(path, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerow(["benchmark", "median_seconds", "rows_per_second"])
+        for name, (median, rows_per_second) in sorted(results.items()):
+            writer.writerow(
+                [name, "%.6f" % median, "%.0f" % (rows_per_second or 0)]
+            )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--runner", required=True, help="benchmark_runner path")
+    parser.add_argument("--pattern", default="benchmark/h3/.*")
+    parser.add_argument("--baseline", default="benchmark/h3/baseline.csv")
+    parser.add_argument(
+        "--save-baseline",
+        action="store_true",
+        help="store the results as the new baseline instead of comparing",
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.10,
+        help="slowdown (as a fraction) reported as a regression",
+    )
+    args = parser.parse_args()
+
+    results = summarize(run(args.runner, args.pattern))
+    if not results:
+        sys.exit("no benchmark results were found in the runner output")
+
+    if args.save_baseline:
+        write_baseline(args.baseline, results)
+        print("Stored baseline for %d benchmarks in %s" %
+              (len(results), args.baseline))
+        return
+
+    baseline = read_baseline(args.baseline)
+    regressions = []
+    print("%-50s %12s %14s %10s" % ("benchmark", "median (s)", "rows/sec",
+                                    "change"))
+    for name, (median, rows_per_second) in results.items():
+        change = ""
+        if name in baseline and baseline[name] > 0:
+            slowdown = median / baseline[name] - 1
+            change = "%+.1f%%" % (slowdown * 100)
+            if slowdown > args.threshold:
+                regressions.append(name)
+                change += " !"
+        rate = "%.0f" % rows_per_second if rows_per_second else "-"
+        print("%-50s %12.4f %14s %10s" % (name, median, rate, change))
+
+    if not baseline:
+        print("No baseline at %s; run `make bench_baseline` to store one" %
+              args.baseline)
+    if regressions:
+        print("%d benchmark(s) regressed by more than %.0f%%" %
+              (len(regressions), args.threshold * 100))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,6 +2,8 @@
 
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/storage/statistics/numeric_stats.hpp"
 
 namespace duckdb {
 
@@ -11,4 +13,113 @@ void ThrowH3Error(H3Error err) {
   }
 }
 
+bool TryGetConstantArgument(ClientContext &context, Expression &arg,
+                            Value &out) {
+  if (!arg.IsFoldable()) {
+    return false;
+  }
+  out = ExpressionExecutor::EvaluateScalar(context, arg);
+  return !out.IsNull();
+}
+
+bool TryGetCellRange(const BaseStatistics &stats, H3Index &min,
+                     H3Index &max) {
+  if (!NumericStats::HasMinMax(stats)) {
+    return false;
+  }
+  switch (stats.GetType().id()) {
+  case LogicalTypeId::UBIGINT:
+    min = NumericStats::GetMin<uint64_t>(stats);
+    max = NumericStats::GetMax<uint64_t>(stats);
+    return true;
+  case LogicalTypeId::BIGINT: {
+    auto signedMin = NumericStats::GetMin<int64_t>(stats);
+    auto signedMax = NumericStats::GetMax<int64_t>(stats);
+    if (signedMin < 0) {
+      return false;
+    }
+    min = signedMin;
+    max = signedMax;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+LogicalType H3SetType() {
+  auto type = LogicalType(LogicalTypeId::BLOB);
+  type.SetAlias("H3SET");
+  return type;
+}
+
+H3Error CellToChildrenRange(H3Index cell, int res, H3Index &min,
+                            H3Index &max) {
+  H3Error err = cellToCenterChild(cell, res, &min);
+  if (err) {
+    return err;
+  }
+  // The center child has digit 0 below the cell, and the largest child has
+  // digit 6
+  max = min;
+  for (int digitRes = getResolution(cell) + 1; digitRes <= res; digitRes++) {
+    max |= H3Index(6) << (3 * (MAX_H3_RES - digitRes));
+  }
+  return E_SUCCESS;
+}
+
+bool SpanBefore(const CellSpan &a, const CellSpan &b) {
+  return a.min < b.min || (a.min == b.min && a.max > b.max);
+}
+
+void RemoveCoveredSpans(vector<CellSpan> &spans) {
+  idx_t kept = 0;
+  for (auto &span : spans) {
+    if (!kept || span.min > spans[kept - 1].max) {
+      spans[kept++] = span;
+    }
+  }
+  spans.resize(kept);
+}
+
+// Sorted, disjoint spans keep siblings adjacent, so this only looks at the
+// last spans written
+void CompactSpans(vector<CellSpan> &spans) {
+  vector<CellSpan> compacted;
+  for (auto &span : spans) {
+    compacted.push_back(span);
+    while (true) {
+      H3Index cell = compacted.back().cell;
+      int res = getResolution(cell);
+      if (res == 0) {
+        break;
+      }
+      H3Index parent;
+      cellToParent(cell, res - 1, &parent);
+      idx_t siblings = isPentagon(parent) ? 6 : 7;
+      if (compacted.size() < siblings) {
+        break;
+      }
+      bool complete = true;
+      for (idx_t k = compacted.size() - siblings; k < compacted.size(); k++) {
+        H3Index sibling = compacted[k].cell;
+        H3Index siblingParent;
+        if (getResolution(sibling) != res ||
+            cellToParent(sibling, res - 1, &siblingParent) ||
+            siblingParent != parent) {
+          complete = false;
+          break;
+        }
+      }
+      if (!complete) {
+        break;
+      }
+      compacted.resize(compacted.size() - siblings);
+      compacted.push_back(CellSpan::Of(parent));
+    }
+  }
+  spans = std::move(compacted);
+}
+
+
 } // namespace duckdb
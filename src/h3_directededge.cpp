@@ -1,33 +1,138 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
 #include "well_known_encoder.hpp"
 
+#include "duckdb/catalog/default/default_table_functions.hpp"
+#include "duckdb/common/types/value.hpp"
+
+extern "C" {
+#include "constants.h"
+#include "coordijk.h"
+#include "h3Index.h"
+}
+
 namespace duckdb {
 
-static void DirectedEdgeToCellsFunction(DataChunk &args, ExpressionState &state,
-                                        Vector &result) {
-  auto result_data = FlatVector::GetData<list_entry_t>(result);
-  for (idx_t i = 0; i < args.size(); i++) {
-    result_data[i].offset = ListVector::GetListSize(result);
+// Same as getDirectedEdgeOrigin, which only inspects the mode bits, but
+// inlined into the kernels.
+static inline H3Error DirectedEdgeOrigin(H3Index edge, H3Index *out) {
+  if (H3_GET_MODE(edge) != H3_DIRECTEDEDGE_MODE) {
+    return E_DIR_EDGE_INVALID;
+  }
+  H3Index origin = edge;
+  H3_SET_MODE(origin, H3_CELL_MODE);
+  H3_SET_RESERVED_BITS(origin, 0);
+  *out = origin;
+  return E_SUCCESS;
+}
 
-    uint64_t edge = args.GetValue(0, i)
-                        .DefaultCastAs(LogicalType::UBIGINT)
-                        .GetValue<uint64_t>();
-    std::vector<H3Index> out(2);
-    H3Error err = directedEdgeToCells(edge, out.data());
-    if (err) {
-      result.SetValue(i, Value(LogicalType::SQLNULL));
-    } else {
-      ListVector::PushBack(result, Value::UBIGINT(out[0]));
-      ListVector::PushBack(result, Value::UBIGINT(out[1]));
+static H3Index MakeDirectedEdge(H3Index origin, int direction) {
+  H3Index edge = origin;
+  H3_SET_MODE(edge, H3_DIRECTEDEDGE_MODE);
+  H3_SET_RESERVED_BITS(edge, direction);
+  return edge;
+}
+
+static bool IsBaseCellPentagon(H3Index h) {
+  H3Index baseCell = H3_INIT;
+  H3_SET_MODE(baseCell, H3_CELL_MODE);
+  H3_SET_BASE_CELL(baseCell, H3_GET_BASE_CELL(h));
+  return isPentagon(baseCell);
+}
+
+// Within a non-pentagon base cell all cells share the base cell's coordinate
+// system, so the edge back from the destination points in the opposite
+// direction (7 - d). This avoids searching all directions of the destination
+// for the origin. Other edges go through reverseDirectedEdge.
+static H3Error ReverseDirectedEdge(H3Index edge, H3Index *out) {
+  int direction = H3_GET_RESERVED_BITS(edge);
+  if (isValidDirectedEdge(edge) && !IsBaseCellPentagon(edge)) {
+    H3Index destination;
+    if (!getDirectedEdgeDestination(edge, &destination) &&
+        H3_GET_BASE_CELL(destination) == H3_GET_BASE_CELL(edge)) {
+      *out = MakeDirectedEdge(destination, 7 - direction);
+      return E_SUCCESS;
+    }
+  }
+  return reverseDirectedEdge(edge, out);
+}
+
+// Direction from the sibling with digit [a] to the sibling with digit [b], or
+// INVALID_DIGIT if they are not adjacent.
+static const int SIBLING_DIRECTIONS[7][7] = {
+    {INVALID_DIGIT, 1, 2, 3, 4, 5, 6},
+    {6, INVALID_DIGIT, INVALID_DIGIT, 2, INVALID_DIGIT, 4, INVALID_DIGIT},
+    {5, INVALID_DIGIT, INVALID_DIGIT, 1, INVALID_DIGIT, INVALID_DIGIT, 4},
+    {4, 5, 6, INVALID_DIGIT, INVALID_DIGIT, INVALID_DIGIT, INVALID_DIGIT},
+    {3, INVALID_DIGIT, INVALID_DIGIT, INVALID_DIGIT, INVALID_DIGIT, 1, 2},
+    {2, 3, INVALID_DIGIT, INVALID_DIGIT, 6, INVALID_DIGIT, INVALID_DIGIT},
+    {1, INVALID_DIGIT, 3, INVALID_DIGIT, 5, INVALID_DIGIT, INVALID_DIGIT}};
+
+// True if the two cells have the same parent, i.e. every bit above the last
+// digit is equal.
+static bool AreSiblingCells(H3Index a, H3Index b, int res) {
+  int parentShift = (MAX_H3_RES - res + 1) * H3_PER_DIGIT_OFFSET;
+  return ((a ^ b) >> parentShift) == 0;
+}
+
+// Siblings in a non-pentagon base cell are resolved from their last digits
+// with a lookup. Other pairs go through cellsToDirectedEdge, which searches
+// the neighbors of the origin.
+static H3Error CellsToDirectedEdge(H3Index origin, H3Index destination,
+                                   H3Index *out) {
+  int res = H3_GET_RESOLUTION(origin);
+  if (res > 0 && isValidCell(origin) && isValidCell(destination) &&
+      AreSiblingCells(origin, destination, res) &&
+      !IsBaseCellPentagon(origin)) {
+    int direction = SIBLING_DIRECTIONS[H3_GET_INDEX_DIGIT(origin, res)]
+                                      [H3_GET_INDEX_DIGIT(destination, res)];
+    if (direction != INVALID_DIGIT) {
+      *out = MakeDirectedEdge(origin, direction);
+      return E_SUCCESS;
+    }
+  }
+  return cellsToDirectedEdge(origin, destination, out);
+}
 
-      result_data[i].length = 2;
+// Results are written straight into the list child vector, which is
+// reserved up front for the maximum number of cells per row.
+template <typename T>
+static void DirectedEdgeToCellsFunction(DataChunk &args, ExpressionState &state,
+                                        Vector &result) {
+  auto count = args.size();
+  UnifiedVectorFormat input_data;
+  args.data[0].ToUnifiedFormat(count, input_data);
+  auto inputs = UnifiedVectorFormat::GetData<T>(input_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_entries = FlatVector::GetData<list_entry_t>(result);
+  auto &result_validity = FlatVector::Validity(result);
+
+  idx_t offset = ListVector::GetListSize(result);
+  ListVector::Reserve(result, offset + count * 2);
+  auto child_data = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+
+  for (idx_t i = 0; i < count; i++) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 0;
+
+    auto idx = input_data.sel->get_index(i);
+    H3Index cells[2];
+    if (!input_data.validity.RowIsValid(idx) ||
+        directedEdgeToCells(inputs[idx], cells)) {
+      result_validity.SetInvalid(i);
+      continue;
     }
+    child_data[offset++] = cells[0];
+    child_data[offset++] = cells[1];
+    result_entries[i].length = 2;
   }
+  ListVector::SetListSize(result, offset);
   if (args.AllConstant()) {
     result.SetVectorType(VectorType::CONSTANT_VECTOR);
   }
-  result.Verify(args.size());
+  result.Verify(count);
 }
 
 static void DirectedEdgeToCellsVarcharFunction(DataChunk &args,
@@ -51,6 +156,7 @@ static void DirectedEdgeToCellsVarcharFunction(DataChunk &args,
       if (err1) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         auto str0 = StringUtil::Format("%llx", out[0]);
         ListVector::PushBack(result, str0);
         auto str1 = StringUtil::Format("%llx", out[1]);
@@ -66,38 +172,49 @@ static void DirectedEdgeToCellsVarcharFunction(DataChunk &args,
   result.Verify(args.size());
 }
 
+template <typename T>
 static void OriginToDirectedEdgesFunction(DataChunk &args,
                                           ExpressionState &state,
                                           Vector &result) {
   D_ASSERT(result.GetType().id() == LogicalTypeId::LIST);
 
-  auto result_data = FlatVector::GetData<list_entry_t>(result);
-  for (idx_t i = 0; i < args.size(); i++) {
-    result_data[i].offset = ListVector::GetListSize(result);
-
-    uint64_t origin = args.GetValue(0, i)
-                          .DefaultCastAs(LogicalType::UBIGINT)
-                          .GetValue<uint64_t>();
-    int64_t actual = 0;
-    std::vector<H3Index> out(6);
-    H3Error err = originToDirectedEdges(origin, out.data());
-    if (err) {
-      result.SetValue(i, Value(LogicalType::SQLNULL));
-    } else {
-      for (auto val : out) {
-        if (val != H3_NULL) {
-          ListVector::PushBack(result, Value::UBIGINT(val));
-          actual++;
-        }
+  auto count = args.size();
+  UnifiedVectorFormat input_data;
+  args.data[0].ToUnifiedFormat(count, input_data);
+  auto inputs = UnifiedVectorFormat::GetData<T>(input_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_entries = FlatVector::GetData<list_entry_t>(result);
+  auto &result_validity = FlatVector::Validity(result);
+
+  idx_t offset = ListVector::GetListSize(result);
+  ListVector::Reserve(result, offset + count * 6);
+  auto child_data = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+
+  for (idx_t i = 0; i < count; i++) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 0;
+
+    auto idx = input_data.sel->get_index(i);
+    H3Index edges[6];
+    if (!input_data.validity.RowIsValid(idx) ||
+        originToDirectedEdges(inputs[idx], edges)) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+    for (auto edge : edges) {
+      // Pentagons have only five edges
+      if (edge != H3_NULL) {
+        child_data[offset++] = edge;
       }
-
-      result_data[i].length = actual;
     }
+    result_entries[i].length = offset - result_entries[i].offset;
   }
+  ListVector::SetListSize(result, offset);
   if (args.AllConstant()) {
     result.SetVectorType(VectorType::CONSTANT_VECTOR);
   }
-  result.Verify(args.size());
+  result.Verify(count);
 }
 
 static void OriginToDirectedEdgesVarcharFunction(DataChunk &args,
@@ -124,6 +241,7 @@ static void OriginToDirectedEdgesVarcharFunction(DataChunk &args,
       if (err1) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         for (auto val : out) {
           if (val != H3_NULL) {
             auto str = StringUtil::Format("%llx", val);
@@ -150,7 +268,7 @@ static void GetDirectedEdgeOriginFunction(DataChunk &args,
   UnaryExecutor::ExecuteWithNulls<T, T>(
       inputs, result, args.size(), [&](T input, ValidityMask &mask, idx_t idx) {
         H3Index out;
-        H3Error err = getDirectedEdgeOrigin(input, &out);
+        H3Error err = DirectedEdgeOrigin(input, &out);
         if (err) {
           mask.SetInvalid(idx);
           return H3Index(H3_NULL);
@@ -174,11 +292,12 @@ static void GetDirectedEdgeOriginVarcharFunction(DataChunk &args,
           return StringVector::EmptyString(result, 0);
         } else {
           H3Index out;
-          H3Error err1 = getDirectedEdgeOrigin(input, &out);
+          H3Error err1 = DirectedEdgeOrigin(input, &out);
           if (err1) {
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", out);
             return StringVector::AddString(result, str);
           }
@@ -223,6 +342,7 @@ static void GetDirectedEdgeDestinationVarcharFunction(DataChunk &args,
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", out);
             return StringVector::AddString(result, str);
           }
@@ -239,7 +359,7 @@ static void CellsToDirectedEdgeFunction(DataChunk &args, ExpressionState &state,
       inputs, inputs2, result, args.size(),
       [&](T input, T input2, ValidityMask &mask, idx_t idx) {
         H3Index out;
-        H3Error err = cellsToDirectedEdge(input, input2, &out);
+        H3Error err = CellsToDirectedEdge(input, input2, &out);
         if (err) {
           mask.SetInvalid(idx);
           return H3Index(H3_NULL);
@@ -266,11 +386,12 @@ static void CellsToDirectedEdgeVarcharFunction(DataChunk &args,
           return StringVector::EmptyString(result, 0);
         } else {
           H3Index out;
-          H3Error err = cellsToDirectedEdge(input, input2, &out);
+          H3Error err = CellsToDirectedEdge(input, input2, &out);
           if (err) {
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", out);
             return StringVector::AddString(result, str);
           }
@@ -285,7 +406,7 @@ static void ReverseDirectedEdgeFunction(DataChunk &args, ExpressionState &state,
   UnaryExecutor::ExecuteWithNulls<T, T>(
       inputs, result, args.size(), [&](T input, ValidityMask &mask, idx_t idx) {
         H3Index out;
-        H3Error err = reverseDirectedEdge(input, &out);
+        H3Error err = ReverseDirectedEdge(input, &out);
         if (err) {
           mask.SetInvalid(idx);
           return H3Index(H3_NULL);
@@ -309,11 +430,12 @@ static void ReverseDirectedEdgeVarcharFunction(DataChunk &args,
           return StringVector::EmptyString(result, 0);
         } else {
           H3Index out;
-          H3Error err = reverseDirectedEdge(input, &out);
+          H3Error err = ReverseDirectedEdge(input, &out);
           if (err) {
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", out);
             return StringVector::AddString(result, str);
           }
@@ -403,6 +525,7 @@ template <typename Encoder> struct DirectedEdgeToBoundaryOperator {
       mask.SetInvalid(idx);
       return StringVector::EmptyString(result, 0);
     } else {
+      H3StatsMaterialize materialize;
       auto enc = Encoder();
       enc.StartLineString();
       for (int i = 0; i <= boundary.numVerts; i++) {
@@ -412,7 +535,6 @@ template <typename Encoder> struct DirectedEdgeToBoundaryOperator {
       }
       enc.EndLineString();
       auto str = enc.Finish();
-
       return StringVector::AddStringOrBlob(result, str);
     }
   }
@@ -459,14 +581,38 @@ static void DirectedEdgeToBoundaryVarcharFunction(DataChunk &args,
       DirectedEdgeToBoundaryVarcharOperator<Encoder>{result});
 }
 
+// Emits the directed edges between cells of a relation with a cell column.
+// The distinct valid cells are built once into the hash table of the join,
+// and each cell's edges probe it for their destination in parallel. Cells
+// stream from the scan, so the input is never held in one list.
+static const DefaultTableMacro CELLS_TO_EDGE_GRAPH_MACRO = {
+    DEFAULT_SCHEMA,
+    "h3_cells_to_edge_graph",
+    {"cells", nullptr},
+    {{"include_length", "false"}, {nullptr, nullptr}},
+    R"(
+WITH cell_set AS (
+  SELECT DISTINCT cell::UBIGINT AS cell FROM query_table(cells)
+  WHERE h3_is_valid_cell(cell)
+)
+SELECT origin, destination.cell AS destination, edge,
+  CASE WHEN include_length THEN h3_edge_length(edge, 'm') END AS length_m
+FROM (
+  SELECT cell AS origin, unnest(h3_origin_to_directed_edges(cell)) AS edge
+  FROM cell_set
+) origin
+JOIN cell_set destination
+  ON destination.cell = h3_get_directed_edge_destination(origin.edge)
+)"};
+
 CreateScalarFunctionInfo H3Functions::GetDirectedEdgeToCellsFunction() {
   ScalarFunctionSet funcs("h3_directed_edge_to_cells");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT},
                                    LogicalType::LIST(LogicalType::UBIGINT),
-                                   DirectedEdgeToCellsFunction));
+                                   DirectedEdgeToCellsFunction<uint64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT},
                                    LogicalType::LIST(LogicalType::UBIGINT),
-                                   DirectedEdgeToCellsFunction));
+                                   DirectedEdgeToCellsFunction<int64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR},
                                    LogicalType::LIST(LogicalType::VARCHAR),
                                    DirectedEdgeToCellsVarcharFunction));
@@ -477,10 +623,10 @@ CreateScalarFunctionInfo H3Functions::GetOriginToDirectedEdgesFunction() {
   ScalarFunctionSet funcs("h3_origin_to_directed_edges");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT},
                                    LogicalType::LIST(LogicalType::UBIGINT),
-                                   OriginToDirectedEdgesFunction));
+                                   OriginToDirectedEdgesFunction<uint64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT},
                                    LogicalType::LIST(LogicalType::UBIGINT),
-                                   OriginToDirectedEdgesFunction));
+                                   OriginToDirectedEdgesFunction<int64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR},
                                    LogicalType::LIST(LogicalType::VARCHAR),
                                    OriginToDirectedEdgesVarcharFunction));
@@ -589,4 +735,9 @@ CreateScalarFunctionInfo H3Functions::GetReverseDirectedEdgeFunction() {
   return CreateScalarFunctionInfo(funcs);
 }
 
+unique_ptr<CreateMacroInfo> H3Functions::GetCellsToEdgeGraphMacro() {
+  return DefaultTableFunctionGenerator::CreateTableMacroInfo(
+      CELLS_TO_EDGE_GRAPH_MACRO);
+}
+
 } // namespace duckdb
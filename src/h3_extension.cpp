@@ -1,7 +1,11 @@
 #include "h3_extension.hpp"
 
+#include "duckdb/main/config.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
+#include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_optimizer.hpp"
+#include "h3_stats.hpp"
 #include "h3api.h"
 
 namespace duckdb {
@@ -13,9 +17,27 @@ static void LoadInternal(ExtensionLoader &loader) {
                          H3_VERSION_MAJOR, H3_VERSION_MINOR, H3_VERSION_PATCH);
   loader.SetDescription(description);
 
+  auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+  config.AddExtensionOption(
+      "h3_stats_enabled",
+      "Collect execution counters of H3 functions, reported by h3_stats()",
+      LogicalType::BOOLEAN, Value::BOOLEAN(false));
+  H3Optimizer::Register(config);
+  loader.RegisterType("H3SET", H3SetType());
+
   for (auto &fun : H3Functions::GetFunctions()) {
+    H3Stats::Instrument(fun);
+    loader.RegisterFunction(fun);
+  }
+  for (auto &fun : H3Functions::GetTableFunctions()) {
     loader.RegisterFunction(fun);
   }
+  for (auto &fun : H3Functions::GetAggregateFunctions()) {
+    loader.RegisterFunction(fun);
+  }
+  for (auto &macro : H3Functions::GetTableMacros()) {
+    loader.RegisterFunction(*macro);
+  }
 }
 
 void H3Extension::Load(ExtensionLoader &loader) { LoadInternal(loader); }
@@ -1,8 +1,72 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
+
+#include "duckdb/catalog/default/default_table_functions.hpp"
+#include "duckdb/storage/statistics/numeric_stats.hpp"
+
+#include <algorithm>
 
 namespace duckdb {
 
+// Digits finer than res, which are all 7 in a cell of resolution res
+static H3Index UnusedDigitsMask(int res) {
+  return (H3Index(1) << (3 * (MAX_H3_RES - res))) - 1;
+}
+
+static constexpr H3Index H3_RES_BITS = H3Index(0xF) << 52;
+
+// The parent and the center child of a cell keep its base cell and leading
+// digits, and set the digits between the two resolutions to 7 (parent) or 0
+// (center child). The digits after both resolutions are copied from the
+// input: they are 7 in a valid cell, but the kernels do not check that. For
+// cells of one resolution (the minimum and maximum share the bits above the
+// base cell) the results are then bounded by those of the minimum with the
+// copied digits cleared, and of the maximum with them set.
+template <bool CENTER_CHILD, bool MAX>
+static H3Index RelativeCellBits(H3Index cell, int res) {
+  int cellRes = (int)((cell & H3_RES_BITS) >> 52);
+  int keptRes = CENTER_CHILD ? cellRes : res;
+  int copiedRes = MaxValue(cellRes, res);
+  H3Index bits = (cell & ~H3_RES_BITS & ~UnusedDigitsMask(keptRes)) |
+                 (H3Index(res) << 52);
+  if (!CENTER_CHILD) {
+    bits |= UnusedDigitsMask(res) & ~UnusedDigitsMask(copiedRes);
+  }
+  return MAX ? bits | UnusedDigitsMask(copiedRes) : bits;
+}
+
+template <bool CENTER_CHILD>
+static unique_ptr<BaseStatistics>
+RelativeCellStatistics(ClientContext &context, FunctionStatisticsInput &input) {
+  auto &child_stats = input.child_stats;
+  H3Index minCell, maxCell;
+  if (!TryGetCellRange(child_stats[0], minCell, maxCell) ||
+      (minCell >> 52) != (maxCell >> 52) ||
+      !NumericStats::HasMinMax(child_stats[1])) {
+    return nullptr;
+  }
+  auto res = NumericStats::GetMin<int32_t>(child_stats[1]);
+  if (res != NumericStats::GetMax<int32_t>(child_stats[1]) || res < 0 ||
+      res > MAX_H3_RES) {
+    return nullptr;
+  }
+
+  auto &type = input.expr.return_type;
+  auto stats = NumericStats::CreateEmpty(type);
+  NumericStats::SetMin(
+      stats,
+      Value::UBIGINT(RelativeCellBits<CENTER_CHILD, false>(minCell, res))
+          .DefaultCastAs(type));
+  NumericStats::SetMax(
+      stats,
+      Value::UBIGINT(RelativeCellBits<CENTER_CHILD, true>(maxCell, res))
+          .DefaultCastAs(type));
+  // NULL for an invalid cell or resolution
+  stats.Set(StatsInfo::CAN_HAVE_NULL_AND_VALID_VALUES);
+  return stats.ToUnique();
+}
+
 template <typename T>
 static void CellToParentFunction(DataChunk &args, ExpressionState &state,
                                  Vector &result) {
@@ -41,6 +105,7 @@ static void CellToParentVarcharFunction(DataChunk &args, ExpressionState &state,
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", parent);
             return StringVector::AddString(result, str);
           }
@@ -71,6 +136,7 @@ static void CellToChildrenFunction(DataChunk &args, ExpressionState &state,
       if (err2) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (auto val : out) {
           if (val != H3_NULL) {
@@ -117,6 +183,7 @@ static void CellToChildrenVarcharFunction(DataChunk &args,
         if (err2) {
           result.SetValue(i, Value(LogicalType::SQLNULL));
         } else {
+          H3StatsMaterialize materialize;
           int64_t actual = 0;
           for (auto val : out) {
             if (val != H3_NULL) {
@@ -202,6 +269,7 @@ static void CellToCenterChildVarcharFunction(DataChunk &args,
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", parent);
             return StringVector::AddString(result, str);
           }
@@ -294,6 +362,7 @@ static void ChildPosToCellVarcharFunction(DataChunk &args,
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", child);
             return StringVector::AddString(result, str);
           }
@@ -321,6 +390,146 @@ static void ChildPosToCellFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
+// Ancestors of a cell, itself included, at each resolution set in the bit
+// mask, coarsest first. The cell is validated once, and each ancestor is then
+// its bits with the resolution replaced and the finer digits set to unused.
+template <typename T>
+static void CellToAncestorsFunction(DataChunk &args, ExpressionState &state,
+                                    Vector &result) {
+  BinaryExecutor::ExecuteWithNulls<T, int32_t, list_entry_t>(
+      args.data[0], args.data[1], result, args.size(),
+      [&](T input, int32_t resMask, ValidityMask &mask, idx_t idx) {
+        H3Index cell = input;
+        if (!isValidCell(cell)) {
+          mask.SetInvalid(idx);
+          return list_entry_t();
+        }
+        int cellRes = getResolution(cell);
+        idx_t offset = ListVector::GetListSize(result);
+        ListVector::Reserve(result, offset + cellRes + 1);
+        auto child_data =
+            FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+        H3Index cellWithoutRes = cell & ~H3_RES_BITS;
+        idx_t length = 0;
+        for (int res = 0; res <= cellRes; res++) {
+          if (resMask & (1 << res)) {
+            child_data[offset + length++] = cellWithoutRes |
+                                            (H3Index(res) << 52) |
+                                            UnusedDigitsMask(res);
+          }
+        }
+        ListVector::SetListSize(result, offset + length);
+        return list_entry_t(offset, length);
+      });
+}
+
+// Number of resolution 0 cells
+static constexpr int BASE_CELL_COUNT = 122;
+
+// Base cells ordered along a Hilbert curve through their centers, on a
+// longitude/latitude grid, so that nearby base cells get nearby ranks
+struct BaseCellOrder {
+  int rank[BASE_CELL_COUNT];
+  int baseCell[BASE_CELL_COUNT];
+
+  static const BaseCellOrder &Get() {
+    static const BaseCellOrder order;
+    return order;
+  }
+
+private:
+  // Position of (x, y) along a Hilbert curve filling an n by n grid
+  static uint64_t HilbertIndex(uint32_t n, uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+      uint32_t rx = (x & s) > 0;
+      uint32_t ry = (y & s) > 0;
+      d += uint64_t(s) * s * ((3 * rx) ^ ry);
+      if (ry == 0) {
+        if (rx == 1) {
+          x = n - 1 - x;
+          y = n - 1 - y;
+        }
+        std::swap(x, y);
+      }
+    }
+    return d;
+  }
+
+  BaseCellOrder() {
+    constexpr uint32_t GRID_SIZE = 1 << 16;
+    H3Index res0Cells[BASE_CELL_COUNT];
+    getRes0Cells(res0Cells);
+    std::pair<uint64_t, int> curve[BASE_CELL_COUNT];
+    for (int i = 0; i < BASE_CELL_COUNT; i++) {
+      LatLng center;
+      cellToLatLng(res0Cells[i], &center);
+      double lng = radsToDegs(center.lng);
+      double lat = radsToDegs(center.lat);
+      auto x = std::min<uint32_t>((lng + 180) / 360 * GRID_SIZE, GRID_SIZE - 1);
+      auto y = std::min<uint32_t>((lat + 90) / 180 * GRID_SIZE, GRID_SIZE - 1);
+      curve[i] = {HilbertIndex(GRID_SIZE, x, y),
+                  getBaseCellNumber(res0Cells[i])};
+    }
+    std::sort(curve, curve + BASE_CELL_COUNT);
+    for (int i = 0; i < BASE_CELL_COUNT; i++) {
+      baseCell[i] = curve[i].second;
+      rank[curve[i].second] = i;
+    }
+  }
+};
+
+// Sort key of a cell at res: the Hilbert rank of its base cell, followed by
+// its digits down to res, 3 bits each. Cells finer than res are keyed by
+// their ancestor at res.
+template <typename T>
+static void CellToSortKeyFunction(DataChunk &args, ExpressionState &state,
+                                  Vector &result) {
+  auto &order = BaseCellOrder::Get();
+  BinaryExecutor::ExecuteWithNulls<T, int, uint64_t>(
+      args.data[0], args.data[1], result, args.size(),
+      [&](T input, int res, ValidityMask &mask, idx_t idx) {
+        H3Index cell = input;
+        if (!isValidCell(cell) || res < 0 || res > getResolution(cell)) {
+          mask.SetInvalid(idx);
+          return uint64_t(0);
+        }
+        uint64_t key = order.rank[getBaseCellNumber(cell)];
+        for (int digitRes = 1; digitRes <= res; digitRes++) {
+          key = (key << 3) | ((cell >> (3 * (MAX_H3_RES - digitRes))) & 7);
+        }
+        return key;
+      });
+}
+
+static void SortKeyToCellFunction(DataChunk &args, ExpressionState &state,
+                                  Vector &result) {
+  auto &order = BaseCellOrder::Get();
+  BinaryExecutor::ExecuteWithNulls<uint64_t, int, uint64_t>(
+      args.data[0], args.data[1], result, args.size(),
+      [&](uint64_t key, int res, ValidityMask &mask, idx_t idx) {
+        if (res < 0 || res > MAX_H3_RES ||
+            (key >> (3 * res)) >= uint64_t(BASE_CELL_COUNT)) {
+          mask.SetInvalid(idx);
+          return uint64_t(0);
+        }
+        // Cell mode, res and base cell, with every digit unused (7)
+        H3Index cell = (H3Index(1) << 59) | (H3Index(res) << 52) |
+                       (H3Index(order.baseCell[key >> (3 * res)]) << 45) |
+                       ((H3Index(1) << 45) - 1);
+        for (int digitRes = res; digitRes >= 1; digitRes--) {
+          int shift = 3 * (MAX_H3_RES - digitRes);
+          cell = (cell & ~(H3Index(7) << shift)) | (H3Index(key & 7) << shift);
+          key >>= 3;
+        }
+        if (!isValidCell(cell)) {
+          mask.SetInvalid(idx);
+          return uint64_t(0);
+        }
+        return cell;
+      });
+}
+
 static void CompactCellsFunction(DataChunk &args, ExpressionState &state,
                                  Vector &result) {
   D_ASSERT(args.ColumnCount() == 1);
@@ -374,6 +583,7 @@ static void CompactCellsFunction(DataChunk &args, ExpressionState &state,
     if (err) {
       result_validity.SetInvalid(i);
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (size_t k = 0; k < input_set.size(); k++) {
         auto child_val = compacted[k];
@@ -462,6 +672,7 @@ static void CompactCellsVarcharFunction(DataChunk &args, ExpressionState &state,
       if (err) {
         result_validity.SetInvalid(i);
       } else {
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (size_t k = 0; k < input_set.size(); k++) {
           auto child_val = compacted[k];
@@ -557,6 +768,7 @@ static void UncompactCellsFunction(DataChunk &args, ExpressionState &state,
     if (err) {
       result_validity.SetInvalid(i);
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (size_t k = 0; k < uncompacted_sz; k++) {
         auto child_val = uncompacted[k];
@@ -666,6 +878,7 @@ static void UncompactCellsVarcharFunction(DataChunk &args,
       if (err) {
         result_validity.SetInvalid(i);
       } else {
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (size_t k = 0; k < uncompacted_sz; k++) {
           auto child_val = uncompacted[k];
@@ -688,17 +901,173 @@ static void UncompactCellsVarcharFunction(DataChunk &args,
   result.Verify(args.size());
 }
 
+// Reads a list of cells as sorted, disjoint spans, skipping NULLs. Returns
+// false if a cell is invalid.
+template <typename T>
+static bool ReadCellSpans(const list_entry_t &list,
+                          const UnifiedVectorFormat &child_data,
+                          vector<CellSpan> &spans) {
+  auto children = UnifiedVectorFormat::GetData<T>(child_data);
+  spans.clear();
+  for (idx_t j = list.offset; j < list.offset + list.length; j++) {
+    auto child_index = child_data.sel->get_index(j);
+    if (!child_data.validity.RowIsValid(child_index)) {
+      continue;
+    }
+    H3Index cell = children[child_index];
+    if (!isValidCell(cell)) {
+      return false;
+    }
+    spans.push_back(CellSpan::Of(cell));
+  }
+  std::sort(spans.begin(), spans.end(), SpanBefore);
+  RemoveCoveredSpans(spans);
+  return true;
+}
+
+// Appends the parts of a span outside of the given spans, which are sorted,
+// disjoint and overlap it. Only the children that hold part of another span
+// are split further.
+static void SubtractSpans(const CellSpan &span, const CellSpan *begin,
+                          const CellSpan *end, vector<CellSpan> &result) {
+  if (begin == end) {
+    result.push_back(span);
+    return;
+  }
+  int res = getResolution(span.cell);
+  if (begin->Covers(span) || res == MAX_H3_RES) {
+    return;
+  }
+  H3Index children[7];
+  int64_t childCount;
+  if (cellToChildrenSize(span.cell, res + 1, &childCount) ||
+      cellToChildren(span.cell, res + 1, children)) {
+    return;
+  }
+  for (int64_t i = 0; i < childCount; i++) {
+    auto child = CellSpan::Of(children[i]);
+    while (begin != end && begin->max < child.min) {
+      begin++;
+    }
+    auto childEnd = begin;
+    while (childEnd != end && childEnd->min <= child.max) {
+      childEnd++;
+    }
+    SubtractSpans(child, begin, childEnd, result);
+  }
+}
+
+// Operations on the regions covered by two compacted cell lists. The inputs
+// are sorted, disjoint spans, which a merge walks in order; the result is
+// compacted again.
+struct CellsIntersectionOperator {
+  static void Operation(const vector<CellSpan> &left,
+                        const vector<CellSpan> &right,
+                        vector<CellSpan> &result) {
+    idx_t i = 0, j = 0;
+    while (i < left.size() && j < right.size()) {
+      auto &a = left[i];
+      auto &b = right[j];
+      if (a.max < b.min) {
+        i++;
+      } else if (b.max < a.min) {
+        j++;
+      } else if (a.Covers(b)) {
+        result.push_back(b);
+        j++;
+      } else {
+        result.push_back(a);
+        i++;
+      }
+    }
+  }
+};
+
+struct CellsUnionOperator {
+  static void Operation(const vector<CellSpan> &left,
+                        const vector<CellSpan> &right,
+                        vector<CellSpan> &result) {
+    result.resize(left.size() + right.size());
+    std::merge(left.begin(), left.end(), right.begin(), right.end(),
+               result.begin(), SpanBefore);
+    RemoveCoveredSpans(result);
+  }
+};
+
+struct CellsDifferenceOperator {
+  static void Operation(const vector<CellSpan> &left,
+                        const vector<CellSpan> &right,
+                        vector<CellSpan> &result) {
+    idx_t j = 0;
+    for (auto &a : left) {
+      while (j < right.size() && right[j].max < a.min) {
+        j++;
+      }
+      idx_t k = j;
+      while (k < right.size() && right[k].min <= a.max) {
+        k++;
+      }
+      SubtractSpans(a, right.data() + j, right.data() + k, result);
+    }
+  }
+};
+
+template <typename T, class OP>
+static void CellsSetOperationFunction(DataChunk &args, ExpressionState &state,
+                                      Vector &result) {
+  auto count = args.size();
+  auto &left_vector = args.data[0];
+  auto &right_vector = args.data[1];
+  UnifiedVectorFormat left_child;
+  ListVector::GetEntry(left_vector)
+      .ToUnifiedFormat(ListVector::GetListSize(left_vector), left_child);
+  UnifiedVectorFormat right_child;
+  ListVector::GetEntry(right_vector)
+      .ToUnifiedFormat(ListVector::GetListSize(right_vector), right_child);
+
+  vector<CellSpan> left, right, spans;
+  BinaryExecutor::ExecuteWithNulls<list_entry_t, list_entry_t, list_entry_t>(
+      left_vector, right_vector, result, count,
+      [&](const list_entry_t &left_list, const list_entry_t &right_list,
+          ValidityMask &mask, idx_t idx) {
+        if (!ReadCellSpans<T>(left_list, left_child, left) ||
+            !ReadCellSpans<T>(right_list, right_child, right)) {
+          mask.SetInvalid(idx);
+          return list_entry_t();
+        }
+        spans.clear();
+        OP::Operation(left, right, spans);
+        CompactSpans(spans);
+
+        H3StatsMaterialize materialize;
+        idx_t offset = ListVector::GetListSize(result);
+        ListVector::Reserve(result, offset + spans.size());
+        auto child_data =
+            FlatVector::GetData<T>(ListVector::GetEntry(result));
+        for (idx_t k = 0; k < spans.size(); k++) {
+          child_data[offset + k] = spans[k].cell;
+        }
+        ListVector::SetListSize(result, offset + spans.size());
+        return list_entry_t(offset, spans.size());
+      });
+  result.Verify(count);
+}
+
 CreateScalarFunctionInfo H3Functions::GetCellToParentFunction() {
   ScalarFunctionSet funcs("h3_cell_to_parent");
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::INTEGER},
                                    LogicalType::VARCHAR,
                                    CellToParentVarcharFunction));
-  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
-                                   LogicalType::UBIGINT,
-                                   CellToParentFunction<uint64_t>));
-  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::INTEGER},
-                                   LogicalType::BIGINT,
-                                   CellToParentFunction<int64_t>));
+  ScalarFunction ubigint_fun({LogicalType::UBIGINT, LogicalType::INTEGER},
+                             LogicalType::UBIGINT,
+                             CellToParentFunction<uint64_t>);
+  ubigint_fun.statistics = RelativeCellStatistics<false>;
+  funcs.AddFunction(ubigint_fun);
+  ScalarFunction bigint_fun({LogicalType::BIGINT, LogicalType::INTEGER},
+                            LogicalType::BIGINT,
+                            CellToParentFunction<int64_t>);
+  bigint_fun.statistics = RelativeCellStatistics<false>;
+  funcs.AddFunction(bigint_fun);
   return CreateScalarFunctionInfo(funcs);
 }
 
@@ -735,12 +1104,16 @@ CreateScalarFunctionInfo H3Functions::GetCellToCenterChildFunction() {
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::INTEGER},
                                    LogicalType::VARCHAR,
                                    CellToCenterChildVarcharFunction));
-  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
-                                   LogicalType::UBIGINT,
-                                   CellToCenterChildFunction<uint64_t>));
-  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::INTEGER},
-                                   LogicalType::BIGINT,
-                                   CellToCenterChildFunction<int64_t>));
+  ScalarFunction ubigint_fun({LogicalType::UBIGINT, LogicalType::INTEGER},
+                             LogicalType::UBIGINT,
+                             CellToCenterChildFunction<uint64_t>);
+  ubigint_fun.statistics = RelativeCellStatistics<true>;
+  funcs.AddFunction(ubigint_fun);
+  ScalarFunction bigint_fun({LogicalType::BIGINT, LogicalType::INTEGER},
+                            LogicalType::BIGINT,
+                            CellToCenterChildFunction<int64_t>);
+  bigint_fun.statistics = RelativeCellStatistics<true>;
+  funcs.AddFunction(bigint_fun);
   return CreateScalarFunctionInfo(funcs);
 }
 
@@ -773,6 +1146,62 @@ CreateScalarFunctionInfo H3Functions::GetChildPosToCellFunction() {
   return CreateScalarFunctionInfo(funcs);
 }
 
+CreateScalarFunctionInfo H3Functions::GetCellToAncestorsFunction() {
+  ScalarFunctionSet funcs("h3_cell_to_ancestors");
+  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
+                                   LogicalType::LIST(LogicalType::UBIGINT),
+                                   CellToAncestorsFunction<uint64_t>));
+  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::INTEGER},
+                                   LogicalType::LIST(LogicalType::BIGINT),
+                                   CellToAncestorsFunction<int64_t>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+// Joins events (cell, ...) to the zones (cell, ...) whose cell contains them,
+// for zones of mixed resolutions, without uncompacting the zones. Each event
+// probes the hash table of zone cells only with its ancestors at the
+// resolutions that zones have, given by a bit mask.
+static const DefaultTableMacro CONTAINMENT_JOIN_MACRO = {
+    DEFAULT_SCHEMA,
+    "h3_containment_join",
+    {"events", "zones", nullptr},
+    {{nullptr, nullptr}},
+    R"(
+SELECT event.* EXCLUDE (zone_cell), zone.* EXCLUDE (cell),
+  zone.cell AS zone_cell
+FROM (
+  SELECT *, unnest(h3_cell_to_ancestors(cell, (
+    SELECT bit_or(1 << h3_get_resolution(cell)) FROM query_table(zones)
+  ))) AS zone_cell
+  FROM query_table(events)
+) event
+JOIN query_table(zones) zone ON zone.cell = event.zone_cell
+)"};
+
+unique_ptr<CreateMacroInfo> H3Functions::GetContainmentJoinMacro() {
+  return DefaultTableFunctionGenerator::CreateTableMacroInfo(
+      CONTAINMENT_JOIN_MACRO);
+}
+
+CreateScalarFunctionInfo H3Functions::GetCellToSortKeyFunction() {
+  ScalarFunctionSet funcs("h3_cell_to_sort_key");
+  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
+                                   LogicalType::UBIGINT,
+                                   CellToSortKeyFunction<uint64_t>));
+  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::INTEGER},
+                                   LogicalType::UBIGINT,
+                                   CellToSortKeyFunction<int64_t>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSortKeyToCellFunction() {
+  ScalarFunctionSet funcs("h3_sort_key_to_cell");
+  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
+                                   LogicalType::UBIGINT,
+                                   SortKeyToCellFunction));
+  return CreateScalarFunctionInfo(funcs);
+}
+
 CreateScalarFunctionInfo H3Functions::GetCompactCellsFunction() {
   ScalarFunctionSet funcs("h3_compact_cells");
   // TODO: Refactor this to use a templated InputOperator, reference
@@ -805,4 +1234,35 @@ CreateScalarFunctionInfo H3Functions::GetUncompactCellsFunction() {
   return CreateScalarFunctionInfo(funcs);
 }
 
+template <class OP>
+static ScalarFunctionSet GetCellsSetOperationFunctions(const string &name) {
+  ScalarFunctionSet funcs(name);
+  funcs.AddFunction(ScalarFunction({LogicalType::LIST(LogicalType::UBIGINT),
+                                    LogicalType::LIST(LogicalType::UBIGINT)},
+                                   LogicalType::LIST(LogicalType::UBIGINT),
+                                   CellsSetOperationFunction<uint64_t, OP>));
+  funcs.AddFunction(ScalarFunction({LogicalType::LIST(LogicalType::BIGINT),
+                                    LogicalType::LIST(LogicalType::BIGINT)},
+                                   LogicalType::LIST(LogicalType::BIGINT),
+                                   CellsSetOperationFunction<int64_t, OP>));
+  return funcs;
+}
+
+CreateScalarFunctionInfo H3Functions::GetCellsIntersectionFunction() {
+  return CreateScalarFunctionInfo(
+      GetCellsSetOperationFunctions<CellsIntersectionOperator>(
+          "h3_cells_intersection"));
+}
+
+CreateScalarFunctionInfo H3Functions::GetCellsUnionFunction() {
+  return CreateScalarFunctionInfo(
+      GetCellsSetOperationFunctions<CellsUnionOperator>("h3_cells_union"));
+}
+
+CreateScalarFunctionInfo H3Functions::GetCellsDifferenceFunction() {
+  return CreateScalarFunctionInfo(
+      GetCellsSetOperationFunctions<CellsDifferenceOperator>(
+          "h3_cells_difference"));
+}
+
 } // namespace duckdb
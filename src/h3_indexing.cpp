@@ -1,6 +1,7 @@
 #include "fmt/format.h"
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
 #include "well_known_encoder.hpp"
 
 namespace duckdb {
@@ -40,6 +41,7 @@ static void LatLngToCellVarcharFunction(DataChunk &args, ExpressionState &state,
           mask.SetInvalid(idx);
           return StringVector::EmptyString(result, 0);
         } else {
+          H3StatsMaterialize materialize;
           auto str = StringUtil::Format("%llx", cell);
           return StringVector::AddString(result, str);
         }
@@ -143,6 +145,7 @@ static void CellToLatLngFunction(DataChunk &args, ExpressionState &state,
     if (err) {
       result.SetValue(i, Value(LogicalType::SQLNULL));
     } else {
+      H3StatsMaterialize materialize;
       ListVector::PushBack(result, radsToDegs(latLng.lat));
       ListVector::PushBack(result, radsToDegs(latLng.lng));
       result_data[i].length = 2;
@@ -174,6 +177,7 @@ static void CellToLatLngVarcharFunction(DataChunk &args, ExpressionState &state,
       if (err) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         ListVector::PushBack(result, radsToDegs(latLng.lat));
         ListVector::PushBack(result, radsToDegs(latLng.lng));
         result_data[i].length = 2;
@@ -196,6 +200,7 @@ template <typename Encoder> struct CellToBoundaryOperator {
       mask.SetInvalid(idx);
       return StringVector::EmptyString(result, 0);
     } else {
+      H3StatsMaterialize materialize;
       auto enc = Encoder();
       enc.StartPolygon();
       for (int i = 0; i <= boundary.numVerts; i++) {
@@ -206,7 +211,6 @@ template <typename Encoder> struct CellToBoundaryOperator {
       }
       enc.EndPolygon();
       auto str = enc.Finish();
-
       return StringVector::AddStringOrBlob(result, str);
     }
   }
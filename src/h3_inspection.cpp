@@ -1,5 +1,8 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
+
+#include "duckdb/storage/statistics/numeric_stats.hpp"
 
 namespace duckdb {
 
@@ -11,6 +14,29 @@ static void GetResolutionFunction(DataChunk &args, ExpressionState &state,
                                  [&](T cell) { return getResolution(cell); });
 }
 
+// The resolution is read from bits 52 to 55 of the cell. When the minimum
+// and maximum cell share the bits above those, every cell between them has
+// a resolution between theirs; for cells of one resolution it is a constant.
+static unique_ptr<BaseStatistics>
+GetResolutionStatistics(ClientContext &context,
+                        FunctionStatisticsInput &input) {
+  H3Index minCell, maxCell;
+  if (!TryGetCellRange(input.child_stats[0], minCell, maxCell)) {
+    return nullptr;
+  }
+  int minRes = 0;
+  int maxRes = MAX_H3_RES;
+  if ((minCell >> 56) == (maxCell >> 56)) {
+    minRes = getResolution(minCell);
+    maxRes = getResolution(maxCell);
+  }
+  auto stats = NumericStats::CreateEmpty(LogicalType::INTEGER);
+  NumericStats::SetMin(stats, Value::INTEGER(minRes));
+  NumericStats::SetMax(stats, Value::INTEGER(maxRes));
+  stats.CopyValidity(input.child_stats[0]);
+  return stats.ToUnique();
+}
+
 static void GetResolutionVarcharFunction(DataChunk &args,
                                          ExpressionState &state,
                                          Vector &result) {
@@ -121,6 +147,7 @@ static void StringToH3Function(DataChunk &args, ExpressionState &state,
 struct H3ToStringOperator {
   template <class INPUT_TYPE, class RESULT_TYPE>
   static RESULT_TYPE Operation(INPUT_TYPE input, Vector &result) {
+    H3StatsMaterialize materialize;
     auto str = StringUtil::Format("%llx", input);
     return StringVector::AddString(result, str);
   }
@@ -252,6 +279,7 @@ static void GetIcosahedronFacesFunction(DataChunk &args, ExpressionState &state,
       if (err2) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         for (auto val : out) {
           if (val != -1) {
             ListVector::PushBack(result, Value::INTEGER(val));
@@ -296,6 +324,7 @@ static void GetIcosahedronFacesVarcharFunction(DataChunk &args,
         if (err2) {
           result.SetValue(i, Value(LogicalType::SQLNULL));
         } else {
+          H3StatsMaterialize materialize;
           for (auto val : out) {
             if (val != -1) {
               ListVector::PushBack(result, Value::INTEGER(val));
@@ -499,6 +528,7 @@ static void ConstructCellVarcharFunction(DataChunk &args,
     if (err) {
       result_validity.SetInvalid(i);
     } else {
+      H3StatsMaterialize materialize;
       auto str = StringUtil::Format("%llx", out);
       result.SetValue(i, StringVector::AddString(result, str));
     }
@@ -514,10 +544,14 @@ static void ConstructCellVarcharFunction(DataChunk &args,
 
 CreateScalarFunctionInfo H3Functions::GetGetResolutionFunction() {
   ScalarFunctionSet funcs("h3_get_resolution");
-  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT}, LogicalType::INTEGER,
-                                   GetResolutionFunction<uint64_t>));
-  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT}, LogicalType::INTEGER,
-                                   GetResolutionFunction<int64_t>));
+  ScalarFunction ubigint_fun({LogicalType::UBIGINT}, LogicalType::INTEGER,
+                             GetResolutionFunction<uint64_t>);
+  ubigint_fun.statistics = GetResolutionStatistics;
+  funcs.AddFunction(ubigint_fun);
+  ScalarFunction bigint_fun({LogicalType::BIGINT}, LogicalType::INTEGER,
+                            GetResolutionFunction<int64_t>);
+  bigint_fun.statistics = GetResolutionStatistics;
+  funcs.AddFunction(bigint_fun);
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::INTEGER,
                                    GetResolutionVarcharFunction));
   return CreateScalarFunctionInfo(funcs);
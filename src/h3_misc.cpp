@@ -1,10 +1,281 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
+
+extern "C" {
+#include "constants.h"
+#include "h3Index.h"
+}
 
 namespace duckdb {
 
-// TODO: Consider using enums for (km, m, rads) here, instead of VARCHAR
-// (string)
+// Units are passed as VARCHAR. When the unit argument is a constant, it is
+// resolved once at bind time and the function is swapped for a kernel
+// specialized on that unit, so no string comparison happens per row.
+
+enum class H3Unit : uint8_t { KM, M, RADS };
+
+static bool StringToAreaUnit(string_t unit, H3Unit &out) {
+  if (unit == "km^2") {
+    out = H3Unit::KM;
+  } else if (unit == "m^2") {
+    out = H3Unit::M;
+  } else if (unit == "rads^2") {
+    out = H3Unit::RADS;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool StringToLengthUnit(string_t unit, H3Unit &out) {
+  if (unit == "km") {
+    out = H3Unit::KM;
+  } else if (unit == "m") {
+    out = H3Unit::M;
+  } else if (unit == "rads") {
+    out = H3Unit::RADS;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+struct H3KmOperator {
+  static H3Error CellArea(H3Index cell, double *out) {
+    return cellAreaKm2(cell, out);
+  }
+  static H3Error HexagonAreaAvg(int res, double *out) {
+    return getHexagonAreaAvgKm2(res, out);
+  }
+  static H3Error EdgeLength(H3Index edge, double *out) {
+    return edgeLengthKm(edge, out);
+  }
+  static H3Error HexagonEdgeLengthAvg(int res, double *out) {
+    return getHexagonEdgeLengthAvgKm(res, out);
+  }
+  static double GreatCircleDistance(const LatLng *a, const LatLng *b) {
+    return greatCircleDistanceKm(a, b);
+  }
+  static double AreaFromRads2(double rads2) {
+    return rads2 * EARTH_RADIUS_KM * EARTH_RADIUS_KM;
+  }
+};
+
+struct H3MOperator {
+  static H3Error CellArea(H3Index cell, double *out) {
+    return cellAreaM2(cell, out);
+  }
+  static H3Error HexagonAreaAvg(int res, double *out) {
+    return getHexagonAreaAvgM2(res, out);
+  }
+  static H3Error EdgeLength(H3Index edge, double *out) {
+    return edgeLengthM(edge, out);
+  }
+  static H3Error HexagonEdgeLengthAvg(int res, double *out) {
+    return getHexagonEdgeLengthAvgM(res, out);
+  }
+  static double GreatCircleDistance(const LatLng *a, const LatLng *b) {
+    return greatCircleDistanceM(a, b);
+  }
+  static double AreaFromRads2(double rads2) {
+    return H3KmOperator::AreaFromRads2(rads2) * 1000 * 1000;
+  }
+};
+
+struct H3RadsOperator {
+  static H3Error CellArea(H3Index cell, double *out) {
+    return cellAreaRads2(cell, out);
+  }
+  static H3Error HexagonAreaAvg(int res, double *out) {
+    // Not provided by the H3 library
+    return E_OPTION_INVALID;
+  }
+  static H3Error EdgeLength(H3Index edge, double *out) {
+    return edgeLengthRads(edge, out);
+  }
+  static H3Error HexagonEdgeLengthAvg(int res, double *out) {
+    // Not provided by the H3 library
+    return E_OPTION_INVALID;
+  }
+  static double GreatCircleDistance(const LatLng *a, const LatLng *b) {
+    return greatCircleDistanceRads(a, b);
+  }
+  static double AreaFromRads2(double rads2) { return rads2; }
+};
+
+// Lookup table for approximate cell areas. The exact area of every hexagon at
+// TABLE_RES is computed once, keyed by base cell and digit prefix. A finer
+// cell is approximated as its ancestor's area divided by 7 per resolution
+// step, which is within 1% of the exact area everywhere on the globe. Cells
+// at or above TABLE_RES, pentagons, and descendants of pentagons are not
+// covered and use the exact computation.
+class ApproxCellAreaTable {
+public:
+  static const ApproxCellAreaTable &Get() {
+    static ApproxCellAreaTable table;
+    return table;
+  }
+
+  bool TryGetRads2(H3Index cell, double &out) const {
+    int res = H3_GET_RESOLUTION(cell);
+    if (res <= TABLE_RES || !isValidCell(cell)) {
+      return false;
+    }
+    double area = areas[Key(cell)];
+    if (area == 0.0) {
+      return false;
+    }
+    out = area * scales[res - TABLE_RES];
+    return true;
+  }
+
+private:
+  static constexpr int TABLE_RES = 4;
+  // 7^TABLE_RES
+  static constexpr idx_t PREFIXES_PER_BASE_CELL = 2401;
+
+  ApproxCellAreaTable()
+      : areas(NUM_BASE_CELLS * PREFIXES_PER_BASE_CELL, 0.0) {
+    scales[0] = 1.0;
+    for (int i = 1; i <= MAX_H3_RES - TABLE_RES; i++) {
+      scales[i] = scales[i - 1] / 7;
+    }
+
+    H3Index baseCells[NUM_BASE_CELLS];
+    ThrowH3Error(getRes0Cells(baseCells));
+    int64_t childrenSize;
+    ThrowH3Error(cellToChildrenSize(baseCells[0], TABLE_RES, &childrenSize));
+    vector<H3Index> children(childrenSize);
+    for (auto baseCell : baseCells) {
+      // Pentagon base cells have fewer children
+      std::fill(children.begin(), children.end(), H3_NULL);
+      ThrowH3Error(cellToChildren(baseCell, TABLE_RES, children.data()));
+      for (auto child : children) {
+        if (child == H3_NULL || isPentagon(child)) {
+          continue;
+        }
+        double area;
+        ThrowH3Error(cellAreaRads2(child, &area));
+        areas[Key(child)] = area;
+      }
+    }
+  }
+
+  static idx_t Key(H3Index cell) {
+    idx_t key = H3_GET_BASE_CELL(cell);
+    for (int r = 1; r <= TABLE_RES; r++) {
+      key = key * 7 + H3_GET_INDEX_DIGIT(cell, r);
+    }
+    return key;
+  }
+
+  vector<double> areas;
+  double scales[MAX_H3_RES - TABLE_RES + 1];
+};
+
+template <class Op> static H3Error ApproxCellArea(H3Index cell, double *out) {
+  double rads2;
+  if (ApproxCellAreaTable::Get().TryGetRads2(cell, rads2)) {
+    *out = Op::AreaFromRads2(rads2);
+    return E_SUCCESS;
+  }
+  return Op::CellArea(cell, out);
+}
+
+template <bool APPROX, class Op>
+static H3Error CellAreaWithMode(H3Index cell, double *out) {
+  return APPROX ? ApproxCellArea<Op>(cell, out) : Op::CellArea(cell, out);
+}
+
+struct H3UnitBindData : public FunctionData {
+  explicit H3UnitBindData(H3Unit _unit) : unit(_unit) {}
+
+  unique_ptr<FunctionData> Copy() const override {
+    return make_uniq<H3UnitBindData>(unit);
+  }
+
+  bool Equals(const FunctionData &other_p) const override {
+    auto &other = other_p.Cast<H3UnitBindData>();
+    return unit == other.unit;
+  }
+
+  H3Unit unit;
+};
+
+static bool InputToH3(uint64_t input, H3Index &out) {
+  out = input;
+  return true;
+}
+
+static bool InputToH3(int64_t input, H3Index &out) {
+  out = input;
+  return true;
+}
+
+static bool InputToH3(string_t input, H3Index &out) {
+  return !stringToH3(input.GetString().c_str(), &out);
+}
+
+// Binds the unit argument (at UNIT_ARG) of a function. Kernels::GetKernel
+// returns the specialized kernel for a unit, or nullptr if the unit is not
+// supported by that function.
+template <class Kernels, idx_t UNIT_ARG>
+static unique_ptr<FunctionData>
+UnitBind(ClientContext &context, ScalarFunction &bound_function,
+         vector<unique_ptr<Expression>> &arguments) {
+  Value unitValue;
+  if (!TryGetConstantArgument(context, *arguments[UNIT_ARG], unitValue)) {
+    return nullptr;
+  }
+  auto &unitStr = StringValue::Get(unitValue);
+  H3Unit unit;
+  scalar_function_t kernel = nullptr;
+  if (Kernels::ParseUnit(string_t(unitStr.c_str(), (uint32_t)unitStr.size()),
+                         unit)) {
+    kernel = Kernels::GetKernel(unit);
+  }
+  if (!kernel) {
+    throw InvalidInputException(StringUtil::Format(
+        "%s: unsupported unit '%s'", bound_function.name, unitStr));
+  }
+  bound_function.function = kernel;
+  return make_uniq<H3UnitBindData>(unit);
+}
+
+template <class Op>
+static void GetHexagonAreaAvgUnitFunction(DataChunk &args,
+                                          ExpressionState &state,
+                                          Vector &result) {
+  UnaryExecutor::ExecuteWithNulls<int, double>(
+      args.data[0], result, args.size(),
+      [&](int res, ValidityMask &mask, idx_t idx) {
+        double out;
+        H3Error err = Op::HexagonAreaAvg(res, &out);
+        if (err) {
+          mask.SetInvalid(idx);
+          return 0.0;
+        } else {
+          return out;
+        }
+      });
+}
+
+struct GetHexagonAreaAvgKernels {
+  static bool ParseUnit(string_t unit, H3Unit &out) {
+    return StringToAreaUnit(unit, out);
+  }
+  static scalar_function_t GetKernel(H3Unit unit) {
+    switch (unit) {
+    case H3Unit::KM:
+      return GetHexagonAreaAvgUnitFunction<H3KmOperator>;
+    case H3Unit::M:
+      return GetHexagonAreaAvgUnitFunction<H3MOperator>;
+    default:
+      return nullptr;
+    }
+  }
+};
 
 static void GetHexagonAreaAvgFunction(DataChunk &args, ExpressionState &state,
                                       Vector &result) {
@@ -12,13 +283,16 @@ static void GetHexagonAreaAvgFunction(DataChunk &args, ExpressionState &state,
   auto &inputs2 = args.data[1];
   BinaryExecutor::ExecuteWithNulls<int, string_t, double>(
       inputs, inputs2, result, args.size(),
-      [&](int res, string_t unit, ValidityMask &mask, idx_t idx) {
+      [&](int res, string_t unitStr, ValidityMask &mask, idx_t idx) {
         double out;
         H3Error err = E_OPTION_INVALID;
-        if (unit == "km^2") {
-          err = getHexagonAreaAvgKm2(res, &out);
-        } else if (unit == "m^2") {
-          err = getHexagonAreaAvgM2(res, &out);
+        H3Unit unit;
+        if (StringToAreaUnit(unitStr, unit)) {
+          if (unit == H3Unit::KM) {
+            err = H3KmOperator::HexagonAreaAvg(res, &out);
+          } else if (unit == H3Unit::M) {
+            err = H3MOperator::HexagonAreaAvg(res, &out);
+          }
         }
         if (err) {
           mask.SetInvalid(idx);
@@ -29,51 +303,142 @@ static void GetHexagonAreaAvgFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
-static double CellAreaFunctionInternal(H3Index cell, string_t unit,
-                                       ValidityMask &mask, idx_t idx) {
-  double out;
-  H3Error err = E_OPTION_INVALID;
-  if (unit == "rads^2") {
-    err = cellAreaRads2(cell, &out);
-  } else if (unit == "km^2") {
-    err = cellAreaKm2(cell, &out);
-  } else if (unit == "m^2") {
-    err = cellAreaM2(cell, &out);
+// Input is commonly clustered (for example, points binned to cells and not
+// yet aggregated), so the area of the previous row is reused when the same
+// cell repeats.
+template <typename T, bool APPROX, class Op>
+static void CellAreaUnitFunction(DataChunk &args, ExpressionState &state,
+                                 Vector &result) {
+  H3Index lastCell = H3_NULL;
+  H3Error lastErr = E_CELL_INVALID;
+  double lastArea = 0.0;
+  UnaryExecutor::ExecuteWithNulls<T, double>(
+      args.data[0], result, args.size(),
+      [&](T input, ValidityMask &mask, idx_t idx) {
+        H3Index cell;
+        if (!InputToH3(input, cell)) {
+          mask.SetInvalid(idx);
+          return 0.0;
+        }
+        if (cell != lastCell) {
+          lastCell = cell;
+          lastErr = CellAreaWithMode<APPROX, Op>(cell, &lastArea);
+        }
+        if (lastErr) {
+          mask.SetInvalid(idx);
+          return 0.0;
+        } else {
+          return lastArea;
+        }
+      });
+}
+
+template <typename T, bool APPROX = false> struct CellAreaKernels {
+  static bool ParseUnit(string_t unit, H3Unit &out) {
+    return StringToAreaUnit(unit, out);
   }
-  if (err) {
-    mask.SetInvalid(idx);
-    return 0.0;
-  } else {
-    return out;
+  static scalar_function_t GetKernel(H3Unit unit) {
+    switch (unit) {
+    case H3Unit::KM:
+      return CellAreaUnitFunction<T, APPROX, H3KmOperator>;
+    case H3Unit::M:
+      return CellAreaUnitFunction<T, APPROX, H3MOperator>;
+    case H3Unit::RADS:
+      return CellAreaUnitFunction<T, APPROX, H3RadsOperator>;
+    default:
+      return nullptr;
+    }
   }
-}
+};
 
-static void CellAreaVarcharFunction(DataChunk &args, ExpressionState &state,
-                                    Vector &result) {
+template <typename T, bool APPROX = false>
+static void CellAreaFunction(DataChunk &args, ExpressionState &state,
+                             Vector &result) {
   auto &inputs = args.data[0];
   auto &inputs2 = args.data[1];
-  BinaryExecutor::ExecuteWithNulls<string_t, string_t, double>(
+  BinaryExecutor::ExecuteWithNulls<T, string_t, double>(
       inputs, inputs2, result, args.size(),
-      [&](string_t cell, string_t unit, ValidityMask &mask, idx_t idx) {
-        H3Index h;
-        H3Error err = stringToH3(cell.GetString().c_str(), &h);
+      [&](T input, string_t unitStr, ValidityMask &mask, idx_t idx) {
+        H3Index cell;
+        double out;
+        H3Error err = E_OPTION_INVALID;
+        H3Unit unit;
+        if (!InputToH3(input, cell)) {
+          err = E_CELL_INVALID;
+        } else if (StringToAreaUnit(unitStr, unit)) {
+          if (unit == H3Unit::KM) {
+            err = CellAreaWithMode<APPROX, H3KmOperator>(cell, &out);
+          } else if (unit == H3Unit::M) {
+            err = CellAreaWithMode<APPROX, H3MOperator>(cell, &out);
+          } else {
+            err = CellAreaWithMode<APPROX, H3RadsOperator>(cell, &out);
+          }
+        }
         if (err) {
           mask.SetInvalid(idx);
           return 0.0;
+        } else {
+          return out;
         }
-        return CellAreaFunctionInternal(h, unit, mask, idx);
       });
 }
 
+// Binds h3_cell_area(cell, unit, approx). The approx flag must be constant,
+// and selects between the exact and approximate kernels.
 template <typename T>
-static void CellAreaFunction(DataChunk &args, ExpressionState &state,
-                             Vector &result) {
-  auto &inputs = args.data[0];
-  auto &inputs2 = args.data[1];
-  BinaryExecutor::ExecuteWithNulls<T, string_t, double>(
-      inputs, inputs2, result, args.size(), CellAreaFunctionInternal);
+static unique_ptr<FunctionData>
+CellAreaApproxBind(ClientContext &context, ScalarFunction &bound_function,
+                   vector<unique_ptr<Expression>> &arguments) {
+  Value approxValue;
+  if (!TryGetConstantArgument(context, *arguments[2], approxValue)) {
+    throw InvalidInputException(StringUtil::Format(
+        "%s: approx must be a constant BOOLEAN", bound_function.name));
+  }
+  if (BooleanValue::Get(approxValue)) {
+    bound_function.function = CellAreaFunction<T, true>;
+    return UnitBind<CellAreaKernels<T, true>, 1>(context, bound_function,
+                                                 arguments);
+  } else {
+    bound_function.function = CellAreaFunction<T, false>;
+    return UnitBind<CellAreaKernels<T, false>, 1>(context, bound_function,
+                                                  arguments);
+  }
 }
 
+template <class Op>
+static void GetHexagonEdgeLengthAvgUnitFunction(DataChunk &args,
+                                                ExpressionState &state,
+                                                Vector &result) {
+  UnaryExecutor::ExecuteWithNulls<int, double>(
+      args.data[0], result, args.size(),
+      [&](int res, ValidityMask &mask, idx_t idx) {
+        double out;
+        H3Error err = Op::HexagonEdgeLengthAvg(res, &out);
+        if (err) {
+          mask.SetInvalid(idx);
+          return 0.0;
+        } else {
+          return out;
+        }
+      });
+}
+
+struct GetHexagonEdgeLengthAvgKernels {
+  static bool ParseUnit(string_t unit, H3Unit &out) {
+    return StringToLengthUnit(unit, out);
+  }
+  static scalar_function_t GetKernel(H3Unit unit) {
+    switch (unit) {
+    case H3Unit::KM:
+      return GetHexagonEdgeLengthAvgUnitFunction<H3KmOperator>;
+    case H3Unit::M:
+      return GetHexagonEdgeLengthAvgUnitFunction<H3MOperator>;
+    default:
+      return nullptr;
+    }
+  }
+};
+
 static void GetHexagonEdgeLengthAvgFunction(DataChunk &args,
                                             ExpressionState &state,
                                             Vector &result) {
@@ -81,13 +446,16 @@ static void GetHexagonEdgeLengthAvgFunction(DataChunk &args,
   auto &inputs2 = args.data[1];
   BinaryExecutor::ExecuteWithNulls<int, string_t, double>(
       inputs, inputs2, result, args.size(),
-      [&](int res, string_t unit, ValidityMask &mask, idx_t idx) {
+      [&](int res, string_t unitStr, ValidityMask &mask, idx_t idx) {
         double out;
         H3Error err = E_OPTION_INVALID;
-        if (unit == "km") {
-          err = getHexagonEdgeLengthAvgKm(res, &out);
-        } else if (unit == "m") {
-          err = getHexagonEdgeLengthAvgM(res, &out);
+        H3Unit unit;
+        if (StringToLengthUnit(unitStr, unit)) {
+          if (unit == H3Unit::KM) {
+            err = H3KmOperator::HexagonEdgeLengthAvg(res, &out);
+          } else if (unit == H3Unit::M) {
+            err = H3MOperator::HexagonEdgeLengthAvg(res, &out);
+          }
         }
         if (err) {
           mask.SetInvalid(idx);
@@ -98,49 +466,83 @@ static void GetHexagonEdgeLengthAvgFunction(DataChunk &args,
       });
 }
 
-static double EdgeLengthFunctionInternal(H3Index edge, string_t unit,
-                                         ValidityMask &mask, idx_t idx) {
-  double out;
-  H3Error err = E_OPTION_INVALID;
-  if (unit == "rads") {
-    err = edgeLengthRads(edge, &out);
-  } else if (unit == "km") {
-    err = edgeLengthKm(edge, &out);
-  } else if (unit == "m") {
-    err = edgeLengthM(edge, &out);
-  }
-  if (err) {
-    mask.SetInvalid(idx);
-    return 0.0;
-  } else {
-    return out;
-  }
-}
-
-static void EdgeLengthVarcharFunction(DataChunk &args, ExpressionState &state,
-                                      Vector &result) {
-  auto &inputs = args.data[0];
-  auto &inputs2 = args.data[1];
-  BinaryExecutor::ExecuteWithNulls<string_t, string_t, double>(
-      inputs, inputs2, result, args.size(),
-      [&](string_t edge, string_t unit, ValidityMask &mask, idx_t idx) {
-        H3Index h;
-        H3Error err = stringToH3(edge.GetString().c_str(), &h);
-        if (err) {
+// As with cell areas, the length of the previous row is reused when the same
+// edge repeats.
+template <typename T, class Op>
+static void EdgeLengthUnitFunction(DataChunk &args, ExpressionState &state,
+                                   Vector &result) {
+  H3Index lastEdge = H3_NULL;
+  H3Error lastErr = E_DIR_EDGE_INVALID;
+  double lastLength = 0.0;
+  UnaryExecutor::ExecuteWithNulls<T, double>(
+      args.data[0], result, args.size(),
+      [&](T input, ValidityMask &mask, idx_t idx) {
+        H3Index edge;
+        if (!InputToH3(input, edge)) {
           mask.SetInvalid(idx);
           return 0.0;
         }
-        return EdgeLengthFunctionInternal(h, unit, mask, idx);
+        if (edge != lastEdge) {
+          lastEdge = edge;
+          lastErr = Op::EdgeLength(edge, &lastLength);
+        }
+        if (lastErr) {
+          mask.SetInvalid(idx);
+          return 0.0;
+        } else {
+          return lastLength;
+        }
       });
 }
 
+template <typename T> struct EdgeLengthKernels {
+  static bool ParseUnit(string_t unit, H3Unit &out) {
+    return StringToLengthUnit(unit, out);
+  }
+  static scalar_function_t GetKernel(H3Unit unit) {
+    switch (unit) {
+    case H3Unit::KM:
+      return EdgeLengthUnitFunction<T, H3KmOperator>;
+    case H3Unit::M:
+      return EdgeLengthUnitFunction<T, H3MOperator>;
+    case H3Unit::RADS:
+      return EdgeLengthUnitFunction<T, H3RadsOperator>;
+    default:
+      return nullptr;
+    }
+  }
+};
+
 template <typename T>
 static void EdgeLengthFunction(DataChunk &args, ExpressionState &state,
                                Vector &result) {
   auto &inputs = args.data[0];
   auto &inputs2 = args.data[1];
   BinaryExecutor::ExecuteWithNulls<T, string_t, double>(
-      inputs, inputs2, result, args.size(), EdgeLengthFunctionInternal);
+      inputs, inputs2, result, args.size(),
+      [&](T input, string_t unitStr, ValidityMask &mask, idx_t idx) {
+        H3Index edge;
+        double out;
+        H3Error err = E_OPTION_INVALID;
+        H3Unit unit;
+        if (!InputToH3(input, edge)) {
+          err = E_DIR_EDGE_INVALID;
+        } else if (StringToLengthUnit(unitStr, unit)) {
+          if (unit == H3Unit::KM) {
+            err = H3KmOperator::EdgeLength(edge, &out);
+          } else if (unit == H3Unit::M) {
+            err = H3MOperator::EdgeLength(edge, &out);
+          } else {
+            err = H3RadsOperator::EdgeLength(edge, &out);
+          }
+        }
+        if (err) {
+          mask.SetInvalid(idx);
+          return 0.0;
+        } else {
+          return out;
+        }
+      });
 }
 
 static void GetNumCellsFunction(DataChunk &args, ExpressionState &state,
@@ -173,6 +575,7 @@ static void GetRes0CellsFunction(DataChunk &args, ExpressionState &state,
       // This should be unreachable
       result.SetValue(i, Value(LogicalType::SQLNULL));
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (auto val : out) {
         if (val != H3_NULL) {
@@ -204,6 +607,7 @@ static void GetRes0CellsVarcharFunction(DataChunk &args, ExpressionState &state,
       // This should be unreachable
       result.SetValue(i, Value(LogicalType::SQLNULL));
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (auto val : out) {
         if (val != H3_NULL) {
@@ -239,6 +643,7 @@ static void GetPentagonsFunction(DataChunk &args, ExpressionState &state,
     if (err1) {
       result.SetValue(i, Value(LogicalType::SQLNULL));
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (auto val : out) {
         if (val != H3_NULL) {
@@ -275,6 +680,7 @@ static void GetPentagonsVarcharFunction(DataChunk &args, ExpressionState &state,
     if (err1) {
       result.SetValue(i, Value(LogicalType::SQLNULL));
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (auto val : out) {
         if (val != H3_NULL) {
@@ -294,76 +700,139 @@ static void GetPentagonsVarcharFunction(DataChunk &args, ExpressionState &state,
   result.Verify(args.size());
 }
 
-static void GreatCircleDistanceFunction(DataChunk &args, ExpressionState &state,
-                                        Vector &result) {
-  UnifiedVectorFormat unitData;
+// Shared loop for h3_great_circle_distance. DistanceFn computes the distance
+// for row i, returning false if the result should be NULL.
+template <class DistanceFn>
+static void GreatCircleDistanceExecute(DataChunk &args, Vector &result,
+                                       DistanceFn &&distanceFn) {
+  auto count = args.size();
+  UnifiedVectorFormat coordData[4];
+  for (idx_t c = 0; c < 4; c++) {
+    args.data[c].ToUnifiedFormat(count, coordData[c]);
+  }
 
-  args.data[4].ToUnifiedFormat(args.size(), unitData);
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_data = FlatVector::GetData<double>(result);
+  auto &result_validity = FlatVector::Validity(result);
 
-  for (idx_t i = 0; i < args.size(); i++) {
-    double dist = 0.0;
+  for (idx_t i = 0; i < count; i++) {
+    double coords[4];
     bool isValid = true;
-
-    if (unitData.validity.RowIsValid(i)) {
-      double lat0 = args.GetValue(0, i)
-                        .DefaultCastAs(LogicalType::DOUBLE)
-                        .GetValue<double>();
-      double lng0 = args.GetValue(1, i)
-                        .DefaultCastAs(LogicalType::DOUBLE)
-                        .GetValue<double>();
-      double lat1 = args.GetValue(2, i)
-                        .DefaultCastAs(LogicalType::DOUBLE)
-                        .GetValue<double>();
-      double lng1 = args.GetValue(3, i)
-                        .DefaultCastAs(LogicalType::DOUBLE)
-                        .GetValue<double>();
-      string_t unit = args.GetValue(4, i).ToString();
-
-      LatLng latLng0 = {.lat = degsToRads(lat0), .lng = degsToRads(lng0)};
-      LatLng latLng1 = {.lat = degsToRads(lat1), .lng = degsToRads(lng1)};
-
-      if (unit == "rads") {
-        dist = greatCircleDistanceRads(&latLng0, &latLng1);
-      } else if (unit == "km") {
-        dist = greatCircleDistanceKm(&latLng0, &latLng1);
-      } else if (unit == "m") {
-        dist = greatCircleDistanceM(&latLng0, &latLng1);
-      } else {
+    for (idx_t c = 0; c < 4; c++) {
+      auto idx = coordData[c].sel->get_index(i);
+      if (!coordData[c].validity.RowIsValid(idx)) {
         isValid = false;
+        break;
       }
-    } else {
-      isValid = false;
+      coords[c] = UnifiedVectorFormat::GetData<double>(coordData[c])[idx];
     }
 
     if (isValid) {
-      result.SetValue(i, Value(dist));
-    } else {
-      result.SetValue(i, Value(LogicalType::SQLNULL));
+      LatLng latLng0 = {.lat = degsToRads(coords[0]),
+                        .lng = degsToRads(coords[1])};
+      LatLng latLng1 = {.lat = degsToRads(coords[2]),
+                        .lng = degsToRads(coords[3])};
+      isValid = distanceFn(i, latLng0, latLng1, result_data[i]);
+    }
+    if (!isValid) {
+      result_validity.SetInvalid(i);
     }
   }
   if (args.AllConstant()) {
     result.SetVectorType(VectorType::CONSTANT_VECTOR);
   }
-  result.Verify(args.size());
+  result.Verify(count);
+}
+
+template <class Op>
+static void GreatCircleDistanceUnitFunction(DataChunk &args,
+                                            ExpressionState &state,
+                                            Vector &result) {
+  GreatCircleDistanceExecute(
+      args, result,
+      [&](idx_t i, const LatLng &latLng0, const LatLng &latLng1, double &out) {
+        out = Op::GreatCircleDistance(&latLng0, &latLng1);
+        return true;
+      });
+}
+
+struct GreatCircleDistanceKernels {
+  static bool ParseUnit(string_t unit, H3Unit &out) {
+    return StringToLengthUnit(unit, out);
+  }
+  static scalar_function_t GetKernel(H3Unit unit) {
+    switch (unit) {
+    case H3Unit::KM:
+      return GreatCircleDistanceUnitFunction<H3KmOperator>;
+    case H3Unit::M:
+      return GreatCircleDistanceUnitFunction<H3MOperator>;
+    case H3Unit::RADS:
+      return GreatCircleDistanceUnitFunction<H3RadsOperator>;
+    default:
+      return nullptr;
+    }
+  }
+};
+
+static void GreatCircleDistanceFunction(DataChunk &args, ExpressionState &state,
+                                        Vector &result) {
+  UnifiedVectorFormat unitData;
+  args.data[4].ToUnifiedFormat(args.size(), unitData);
+  auto units = UnifiedVectorFormat::GetData<string_t>(unitData);
+
+  GreatCircleDistanceExecute(
+      args, result,
+      [&](idx_t i, const LatLng &latLng0, const LatLng &latLng1, double &out) {
+        auto unitIdx = unitData.sel->get_index(i);
+        H3Unit unit;
+        if (!unitData.validity.RowIsValid(unitIdx) ||
+            !StringToLengthUnit(units[unitIdx], unit)) {
+          return false;
+        }
+        if (unit == H3Unit::KM) {
+          out = H3KmOperator::GreatCircleDistance(&latLng0, &latLng1);
+        } else if (unit == H3Unit::M) {
+          out = H3MOperator::GreatCircleDistance(&latLng0, &latLng1);
+        } else {
+          out = H3RadsOperator::GreatCircleDistance(&latLng0, &latLng1);
+        }
+        return true;
+      });
 }
 
 CreateScalarFunctionInfo H3Functions::GetGetHexagonAreaAvgFunction() {
   return CreateScalarFunctionInfo(ScalarFunction(
       "h3_get_hexagon_area_avg", {LogicalType::INTEGER, LogicalType::VARCHAR},
-      LogicalType::DOUBLE, GetHexagonAreaAvgFunction));
+      LogicalType::DOUBLE, GetHexagonAreaAvgFunction,
+      UnitBind<GetHexagonAreaAvgKernels, 1>));
 }
 
 CreateScalarFunctionInfo H3Functions::GetCellAreaFunction() {
   ScalarFunctionSet funcs("h3_cell_area");
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
                                    LogicalType::DOUBLE,
-                                   CellAreaVarcharFunction));
+                                   CellAreaFunction<string_t>,
+                                   UnitBind<CellAreaKernels<string_t>, 1>));
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::VARCHAR},
                                    LogicalType::DOUBLE,
-                                   CellAreaFunction<uint64_t>));
+                                   CellAreaFunction<uint64_t>,
+                                   UnitBind<CellAreaKernels<uint64_t>, 1>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::VARCHAR},
                                    LogicalType::DOUBLE,
-                                   CellAreaFunction<int64_t>));
+                                   CellAreaFunction<int64_t>,
+                                   UnitBind<CellAreaKernels<int64_t>, 1>));
+  funcs.AddFunction(ScalarFunction(
+      {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN},
+      LogicalType::DOUBLE, CellAreaFunction<string_t>,
+      CellAreaApproxBind<string_t>));
+  funcs.AddFunction(ScalarFunction(
+      {LogicalType::UBIGINT, LogicalType::VARCHAR, LogicalType::BOOLEAN},
+      LogicalType::DOUBLE, CellAreaFunction<uint64_t>,
+      CellAreaApproxBind<uint64_t>));
+  funcs.AddFunction(ScalarFunction(
+      {LogicalType::BIGINT, LogicalType::VARCHAR, LogicalType::BOOLEAN},
+      LogicalType::DOUBLE, CellAreaFunction<int64_t>,
+      CellAreaApproxBind<int64_t>));
   return CreateScalarFunctionInfo(funcs);
 }
 
@@ -371,20 +840,24 @@ CreateScalarFunctionInfo H3Functions::GetGetHexagonEdgeLengthAvgFunction() {
   return CreateScalarFunctionInfo(
       ScalarFunction("h3_get_hexagon_edge_length_avg",
                      {LogicalType::INTEGER, LogicalType::VARCHAR},
-                     LogicalType::DOUBLE, GetHexagonEdgeLengthAvgFunction));
+                     LogicalType::DOUBLE, GetHexagonEdgeLengthAvgFunction,
+                     UnitBind<GetHexagonEdgeLengthAvgKernels, 1>));
 }
 
 CreateScalarFunctionInfo H3Functions::GetEdgeLengthFunction() {
   ScalarFunctionSet funcs("h3_edge_length");
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
                                    LogicalType::DOUBLE,
-                                   EdgeLengthVarcharFunction));
+                                   EdgeLengthFunction<string_t>,
+                                   UnitBind<EdgeLengthKernels<string_t>, 1>));
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::VARCHAR},
                                    LogicalType::DOUBLE,
-                                   EdgeLengthFunction<uint64_t>));
+                                   EdgeLengthFunction<uint64_t>,
+                                   UnitBind<EdgeLengthKernels<uint64_t>, 1>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::VARCHAR},
                                    LogicalType::DOUBLE,
-                                   EdgeLengthFunction<int64_t>));
+                                   EdgeLengthFunction<int64_t>,
+                                   UnitBind<EdgeLengthKernels<int64_t>, 1>));
   return CreateScalarFunctionInfo(funcs);
 }
 
@@ -423,7 +896,8 @@ CreateScalarFunctionInfo H3Functions::GetGreatCircleDistanceFunction() {
       "h3_great_circle_distance",
       {LogicalType::DOUBLE, LogicalType::DOUBLE, LogicalType::DOUBLE,
        LogicalType::DOUBLE, LogicalType::VARCHAR},
-      LogicalType::DOUBLE, GreatCircleDistanceFunction));
+      LogicalType::DOUBLE, GreatCircleDistanceFunction,
+      UnitBind<GreatCircleDistanceKernels, 4>));
 }
 
 } // namespace duckdb
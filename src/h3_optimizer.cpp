@@ -0,0 +1,214 @@
+#include "h3_optimizer.hpp"
+#include "h3_common.hpp"
+
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+// Most ranges ORed into one filter. Past that, the filter has one range per
+// child resolution, over the ranges of all parents at that resolution.
+static constexpr idx_t MAX_FILTER_RANGES = 64;
+
+using CellRange = std::pair<H3Index, H3Index>;
+
+// Matches h3_cell_to_parent(column, res) over UBIGINT or BIGINT cells, with
+// a constant resolution
+static bool MatchCellToParent(ClientContext &context, Expression &expr,
+                              optional_ptr<Expression> &column, int &res) {
+  if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+    return false;
+  }
+  auto &func = expr.Cast<BoundFunctionExpression>();
+  if (func.function.name != "h3_cell_to_parent" ||
+      func.children.size() != 2 ||
+      func.children[0]->GetExpressionClass() !=
+          ExpressionClass::BOUND_COLUMN_REF) {
+    return false;
+  }
+  auto type = func.children[0]->return_type.id();
+  if (type != LogicalTypeId::UBIGINT && type != LogicalTypeId::BIGINT) {
+    return false;
+  }
+  Value resValue;
+  if (!TryGetConstantArgument(context, *func.children[1], resValue)) {
+    return false;
+  }
+  res = resValue.GetValue<int32_t>();
+  if (res < 0 || res > MAX_H3_RES) {
+    return false;
+  }
+  column = func.children[0].get();
+  return true;
+}
+
+// The range of the indexes of resolution childRes whose parent at res is
+// parent. cellToParent sets the digits between the two resolutions to 7 and
+// keeps the rest, so this includes malformed indexes with any digit 0 to 7
+// there, not only the children of the parent.
+static CellRange ParentMatchRange(H3Index parent, int res, int childRes) {
+  H3Index digits = ((H3Index(1) << (3 * (MAX_H3_RES - res))) - 1) &
+                   ~((H3Index(1) << (3 * (MAX_H3_RES - childRes))) - 1);
+  H3Index max = (parent & ~(H3Index(0xF) << 52)) | (H3Index(childRes) << 52);
+  return {max & ~digits, max};
+}
+
+// Adds the ranges of the indexes whose parent at res is the constant parent,
+// one for each resolution from res to 15. A parent that is not a valid cell
+// of that resolution can still be the parent of a malformed index, so no
+// filter is derived from it.
+static bool AddParentRanges(ClientContext &context, Expression &expr, int res,
+                            vector<CellRange> &ranges) {
+  Value value;
+  if (!TryGetConstantArgument(context, expr, value) ||
+      !value.DefaultTryCastAs(LogicalType::UBIGINT)) {
+    return false;
+  }
+  H3Index parent = value.GetValue<uint64_t>();
+  if (!isValidCell(parent) || getResolution(parent) != res) {
+    return false;
+  }
+  for (int childRes = res; childRes <= MAX_H3_RES; childRes++) {
+    ranges.push_back(ParentMatchRange(parent, res, childRes));
+  }
+  return true;
+}
+
+// Replaces the sorted ranges with one per resolution. The resolution bits
+// are above the base cell and digits, so each resolution's ranges are
+// adjacent.
+static vector<CellRange> RangesPerResolution(const vector<CellRange> &ranges) {
+  vector<CellRange> result;
+  for (auto &range : ranges) {
+    if (!result.empty() &&
+        (result.back().first >> 52) == (range.first >> 52)) {
+      result.back().second = MaxValue(result.back().second, range.second);
+    } else {
+      result.push_back(range);
+    }
+  }
+  return result;
+}
+
+static unique_ptr<Expression> CompareColumn(ExpressionType type,
+                                            const Expression &column,
+                                            H3Index cell) {
+  return make_uniq<BoundComparisonExpression>(
+      type, column.Copy(),
+      make_uniq<BoundConstantExpression>(
+          Value::UBIGINT(cell).DefaultCastAs(column.return_type)));
+}
+
+static unique_ptr<Expression> RangeFilter(const Expression &column,
+                                          const CellRange &range) {
+  if (range.first == range.second) {
+    return CompareColumn(ExpressionType::COMPARE_EQUAL, column, range.first);
+  }
+  return make_uniq<BoundConjunctionExpression>(
+      ExpressionType::CONJUNCTION_AND,
+      CompareColumn(ExpressionType::COMPARE_GREATERTHANOREQUALTO, column,
+                    range.first),
+      CompareColumn(ExpressionType::COMPARE_LESSTHANOREQUALTO, column,
+                    range.second));
+}
+
+// The column filter implied by a predicate, or nullptr. The predicate is
+// kept, so the filter only has to hold for every row that passes it.
+static unique_ptr<Expression> CellRangeFilter(ClientContext &context,
+                                              Expression &expr) {
+  optional_ptr<Expression> column;
+  int res;
+  vector<CellRange> ranges;
+  if (expr.GetExpressionType() == ExpressionType::COMPARE_EQUAL) {
+    auto &comparison = expr.Cast<BoundComparisonExpression>();
+    if (MatchCellToParent(context, *comparison.left, column, res)) {
+      if (!AddParentRanges(context, *comparison.right, res, ranges)) {
+        return nullptr;
+      }
+    } else if (MatchCellToParent(context, *comparison.right, column, res)) {
+      if (!AddParentRanges(context, *comparison.left, res, ranges)) {
+        return nullptr;
+      }
+    } else {
+      return nullptr;
+    }
+  } else if (expr.GetExpressionType() == ExpressionType::COMPARE_IN) {
+    auto &in = expr.Cast<BoundOperatorExpression>();
+    if (!MatchCellToParent(context, *in.children[0], column, res)) {
+      return nullptr;
+    }
+    for (idx_t i = 1; i < in.children.size(); i++) {
+      if (!AddParentRanges(context, *in.children[i], res, ranges)) {
+        return nullptr;
+      }
+    }
+  } else {
+    return nullptr;
+  }
+
+  // Siblings in an IN list have adjacent ranges, which merge
+  std::sort(ranges.begin(), ranges.end());
+  vector<CellRange> merged;
+  for (auto &range : ranges) {
+    if (!merged.empty() && range.first <= merged.back().second + 1) {
+      merged.back().second = std::max(merged.back().second, range.second);
+    } else {
+      merged.push_back(range);
+    }
+  }
+  if (merged.size() > MAX_FILTER_RANGES) {
+    merged = RangesPerResolution(merged);
+  }
+  if (merged.size() == 1) {
+    return RangeFilter(*column, merged[0]);
+  }
+  auto filter =
+      make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_OR);
+  for (auto &range : merged) {
+    filter->children.push_back(RangeFilter(*column, range));
+  }
+  return std::move(filter);
+}
+
+static void AddCellRangeFilters(ClientContext &context,
+                                unique_ptr<LogicalOperator> &op) {
+  for (auto &child : op->children) {
+    AddCellRangeFilters(context, child);
+  }
+  if (op->type != LogicalOperatorType::LOGICAL_FILTER) {
+    return;
+  }
+  vector<unique_ptr<Expression>> filters;
+  for (auto &expr : op->expressions) {
+    auto filter = CellRangeFilter(context, *expr);
+    if (filter) {
+      filters.push_back(std::move(filter));
+    }
+  }
+  for (auto &filter : filters) {
+    op->expressions.push_back(std::move(filter));
+  }
+}
+
+// Runs before the built in optimizers, so that filter pushdown moves the
+// added filters into the scan
+static void PreOptimize(OptimizerExtensionInput &input,
+                        unique_ptr<LogicalOperator> &plan) {
+  AddCellRangeFilters(input.context, plan);
+}
+
+void H3Optimizer::Register(DBConfig &config) {
+  OptimizerExtension extension;
+  extension.pre_optimize_function = PreOptimize;
+  config.optimizer_extensions.push_back(std::move(extension));
+}
+
+} // namespace duckdb
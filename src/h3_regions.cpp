@@ -1,14 +1,27 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
 #include "well_known_encoder.hpp"
 #include "well_known_decoder.hpp"
 
+// H3's internal headers, for the compact polygon iterator and point in
+// polygon tests
+extern "C" {
+#include "polyfill.h"
+#include "polygon.h"
+}
+
 #include "duckdb/common/helper.hpp"
+#include "duckdb/catalog/default/default_table_functions.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
 
 namespace duckdb {
 
+// Returns UINT32_MAX for invalid flags. Constant flags are resolved once at
+// bind time, see PolygonToCellsBind.
 static uint32_t StringToFlags(string_t flagsStr) {
-  // TODO: Make flags easier to work with
   if (flagsStr == "CONTAINMENT_CENTER" || flagsStr == "center") {
     return 0;
   } else if (flagsStr == "CONTAINMENT_FULL" || flagsStr == "full") {
@@ -116,6 +129,7 @@ static void CellsToMultiPolygonFunction(DataChunk &args, ExpressionState &state,
     if (err) {
       result_validity.SetInvalid(i);
     } else {
+      H3StatsMaterialize materialize;
       auto enc = Encoder();
       auto polygon_count = PolygonCount(&first_lgp);
       enc.StartMultiPolygon(polygon_count);
@@ -154,13 +168,12 @@ static void CellsToMultiPolygonFunction(DataChunk &args, ExpressionState &state,
         enc.MultiPolygonEmpty();
       }
 
+      // BLOB and GEOMETRY results both hold the WKB as is
       auto str = enc.Finish();
       if (IsBlob) {
-        auto added_str = StringVector::AddStringOrBlob(result, str);
-        result.SetValue(i, Value::BLOB(const_data_ptr_cast(added_str.GetData()),
-                                       added_str.GetSize()));
+        result_entries[i] = StringVector::AddStringOrBlob(result, str);
       } else {
-        result.SetValue(i, StringVector::AddString(result, str));
+        result_entries[i] = StringVector::AddString(result, str);
       }
 
       destroyLinkedMultiPolygon(&first_lgp);
@@ -173,380 +186,485 @@ static void CellsToMultiPolygonFunction(DataChunk &args, ExpressionState &state,
   result.Verify(args.size());
 }
 
-static list_entry_t PolygonToCells(Vector &result, GeoPolygon &polygon, int res,
-                                   uint32_t flags) {
-  uint64_t offset = ListVector::GetListSize(result);
-  if (polygon.geoloop.numVerts > 0) {
-    int64_t numCells = 0;
-    H3Error err = maxPolygonToCellsSize(&polygon, res, flags, &numCells);
-    if (err) {
-      return list_entry_t(offset, 0);
-    } else {
-      std::vector<H3Index> out(numCells);
-      H3Error err2 = polygonToCells(&polygon, res, flags, out.data());
-      if (err2) {
-        return list_entry_t(offset, 0);
-      } else {
-        uint64_t actual = 0;
-        for (H3Index outCell : out) {
-          if (outCell != H3_NULL) {
-            ListVector::PushBack(result, Value::UBIGINT(outCell));
-            actual++;
-          }
-        }
-        return list_entry_t(offset, actual);
-      }
-    }
+// Fills a polygon with polygonToCells or polygonToCellsExperimental,
+// appending its cells to out
+template <class Sizes>
+static H3Error AppendPolygonCells(const GeoPolygon &polygon, int res,
+                                  uint32_t flags, std::vector<H3Index> &out) {
+  int64_t numCells = 0;
+  H3Error err = Sizes::MaxSize(polygon, res, flags, numCells);
+  if (err) {
+    return err;
   }
-  return list_entry_t(offset, 0);
+  // Zeroed, as polygonToCells requires
+  size_t start = out.size();
+  out.resize(start + numCells);
+  return Sizes::Fill(polygon, res, flags, numCells, out.data() + start);
 }
 
-static list_entry_t PolygonToCellsExperimental(Vector &result,
-                                               GeoPolygon &polygon, int res,
-                                               uint32_t flags) {
-  uint64_t offset = ListVector::GetListSize(result);
-  if (polygon.geoloop.numVerts > 0) {
-    int64_t numCells = 0;
-    H3Error err =
-        maxPolygonToCellsSizeExperimental(&polygon, res, flags, &numCells);
-    if (err) {
-      return list_entry_t(offset, 0);
-    } else {
-      std::vector<H3Index> out(numCells);
-      H3Error err2 = polygonToCellsExperimental(&polygon, res, flags, numCells,
-                                                out.data());
-      if (err2) {
-        return list_entry_t(offset, 0);
-      } else {
-        uint64_t actual = 0;
-        for (H3Index outCell : out) {
-          if (outCell != H3_NULL) {
-            ListVector::PushBack(result, Value::UBIGINT(outCell));
-            actual++;
-          }
-        }
-        return list_entry_t(offset, actual);
-      }
-    }
+struct PolygonToCellsAlgorithm {
+  // Cells of all parts are at the same resolution
+  static constexpr bool MIXED_RESOLUTIONS = false;
+
+  static H3Error MaxSize(const GeoPolygon &polygon, int res, uint32_t flags,
+                         int64_t &numCells) {
+    return maxPolygonToCellsSize(&polygon, res, flags, &numCells);
   }
-  return list_entry_t(offset, 0);
-}
+  static H3Error Fill(const GeoPolygon &polygon, int res, uint32_t flags,
+                      int64_t numCells, H3Index *out) {
+    return polygonToCells(&polygon, res, flags, out);
+  }
+  static H3Error Append(const GeoPolygon &polygon, int res, uint32_t flags,
+                        std::vector<H3Index> &out) {
+    return AppendPolygonCells<PolygonToCellsAlgorithm>(polygon, res, flags,
+                                                       out);
+  }
+};
 
-static list_entry_t PolygonToCellsVarchar(Vector &result, GeoPolygon &polygon,
-                                          int res, uint32_t flags) {
-  uint64_t offset = ListVector::GetListSize(result);
-  if (polygon.geoloop.numVerts > 0) {
-    int64_t numCells = 0;
-    H3Error err = maxPolygonToCellsSize(&polygon, res, flags, &numCells);
-    if (err) {
-      return list_entry_t(offset, 0);
-    } else {
-      std::vector<H3Index> out(numCells);
-      H3Error err2 = polygonToCells(&polygon, res, flags, out.data());
-      if (err2) {
-        return list_entry_t(offset, 0);
-      } else {
-        uint64_t actual = 0;
-        for (H3Index outCell : out) {
-          if (outCell != H3_NULL) {
-            auto str = StringUtil::Format("%llx", outCell);
-            ListVector::PushBack(result, str);
-            actual++;
-          }
-        }
-        return list_entry_t(offset, actual);
-      }
-    }
+struct PolygonToCellsExperimentalAlgorithm {
+  static constexpr bool MIXED_RESOLUTIONS = false;
+
+  static H3Error MaxSize(const GeoPolygon &polygon, int res, uint32_t flags,
+                         int64_t &numCells) {
+    return maxPolygonToCellsSizeExperimental(&polygon, res, flags, &numCells);
   }
-  return list_entry_t(offset, 0);
-}
+  static H3Error Fill(const GeoPolygon &polygon, int res, uint32_t flags,
+                      int64_t numCells, H3Index *out) {
+    return polygonToCellsExperimental(&polygon, res, flags, numCells, out);
+  }
+  static H3Error Append(const GeoPolygon &polygon, int res, uint32_t flags,
+                        std::vector<H3Index> &out) {
+    return AppendPolygonCells<PolygonToCellsExperimentalAlgorithm>(
+        polygon, res, flags, out);
+  }
+};
 
-static list_entry_t PolygonToCellsExperimentalVarchar(Vector &result,
-                                                      GeoPolygon &polygon,
-                                                      int res, uint32_t flags) {
-  uint64_t offset = ListVector::GetListSize(result);
-  if (polygon.geoloop.numVerts > 0) {
-    int64_t numCells = 0;
-    H3Error err =
-        maxPolygonToCellsSizeExperimental(&polygon, res, flags, &numCells);
-    if (err) {
-      return list_entry_t(offset, 0);
-    } else {
-      std::vector<H3Index> out(numCells);
-      H3Error err2 = polygonToCellsExperimental(&polygon, res, flags, numCells,
-                                                out.data());
-      if (err2) {
-        return list_entry_t(offset, 0);
-      } else {
-        uint64_t actual = 0;
-        for (H3Index outCell : out) {
-          if (outCell != H3_NULL) {
-            auto str = StringUtil::Format("%llx", outCell);
-            ListVector::PushBack(result, str);
-            actual++;
-          }
-        }
-        return list_entry_t(offset, actual);
-      }
+// The compact covering of polygonToCellsExperimental, taken directly from
+// the coarse to fine iterator it is built on. Cells of the polygon interior
+// are emitted as coarse as possible, so the cells at res are never
+// materialized.
+struct PolygonToCellsCompactAlgorithm {
+  static constexpr bool MIXED_RESOLUTIONS = true;
+
+  static H3Error Append(const GeoPolygon &polygon, int res, uint32_t flags,
+                        std::vector<H3Index> &out) {
+    auto iter = iterInitPolygonCompact(&polygon, res, flags);
+    for (; iter.cell; iterStepPolygonCompact(&iter)) {
+      out.push_back(iter.cell);
     }
+    // The iterator frees itself when it finishes or fails
+    return iter.error;
   }
-  return list_entry_t(offset, 0);
-}
+};
 
-static void PolygonWktToCellsFunction(DataChunk &args, ExpressionState &state,
-                                      Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKT strings
-  // will throw, others will return empty lists.
-  BinaryExecutor::Execute<string_t, int, list_entry_t>(
-      args.data[0], args.data[1], result, args.size(),
-      [&](string_t input, int res) {
-        GeoPolygon polygon = {0};
-        int32_t flags = 0;
+struct CellsUbigintOutput {
+  static void PushBack(Vector &result, H3Index cell) {
+    ListVector::PushBack(result, Value::UBIGINT(cell));
+  }
+};
 
-        auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-        std::vector<GeoLoop> holes;
-        std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-        DecodeWktPolygon(input, polygon, outerVerts, holes, holesVerts);
+struct CellsVarcharOutput {
+  static void PushBack(Vector &result, H3Index cell) {
+    ListVector::PushBack(result, StringUtil::Format("%llx", cell));
+  }
+};
 
-        return PolygonToCells(result, polygon, res, flags);
-      });
+// Compacts the cells of several parts, each compact on its own: cells
+// already covered by a coarser cell of another part are dropped, and
+// complete sets of siblings from different parts are replaced by their
+// parent.
+static void CompactPartCells(std::vector<H3Index> &cells) {
+  vector<CellSpan> spans;
+  spans.reserve(cells.size());
+  for (H3Index cell : cells) {
+    spans.push_back(CellSpan::Of(cell));
+  }
+  std::sort(spans.begin(), spans.end(), SpanBefore);
+  RemoveCoveredSpans(spans);
+  CompactSpans(spans);
+  cells.clear();
+  for (auto &span : spans) {
+    cells.push_back(span.cell);
+  }
 }
 
-static void PolygonWktToCellsVarcharFunction(DataChunk &args,
-                                             ExpressionState &state,
-                                             Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKT strings
-  // will throw, others will return empty lists.
-  BinaryExecutor::Execute<string_t, int, list_entry_t>(
-      args.data[0], args.data[1], result, args.size(),
-      [&](string_t input, int res) {
-        GeoPolygon polygon = {0};
-        int32_t flags = 0;
-
-        uint64_t offset = ListVector::GetListSize(result);
-
-        auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-        std::vector<GeoLoop> holes;
-        std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-        DecodeWktPolygon(input, polygon, outerVerts, holes, holesVerts);
+// Computes the cells of the polygons. The parts of a multipolygon are filled
+// one at a time into a single buffer, and cells on the border of two parts
+// are only kept once.
+template <class Algorithm>
+static H3Error PolygonToCells(const DecodedPolygons &decoded, int res,
+                              uint32_t flags, std::vector<H3Index> &cells) {
+  std::vector<H3Index> out;
+  for (auto &polygon : decoded.polygons) {
+    if (polygon.geoloop.numVerts == 0) {
+      continue;
+    }
+    H3Error err = Algorithm::Append(polygon, res, flags, out);
+    if (err) {
+      return err;
+    }
+  }
 
-        return PolygonToCellsVarchar(result, polygon, res, flags);
-      });
+  bool dedupe = decoded.polygons.size() > 1;
+  unordered_set<H3Index> seen;
+  cells.clear();
+  for (H3Index outCell : out) {
+    if (outCell != H3_NULL && (!dedupe || seen.insert(outCell).second)) {
+      cells.push_back(outCell);
+    }
+  }
+  if (dedupe && Algorithm::MIXED_RESOLUTIONS) {
+    CompactPartCells(cells);
+  }
+  return E_SUCCESS;
 }
 
-static void PolygonWkbToCellsFunction(DataChunk &args, ExpressionState &state,
-                                      Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKB strings
-  // will throw, others will return empty lists.
-  BinaryExecutor::Execute<string_t, int, list_entry_t>(
-      args.data[0], args.data[1], result, args.size(),
-      [&](string_t input, int res) {
-        GeoPolygon polygon = {0};
-        int32_t flags = 0;
-
-        uint64_t offset = ListVector::GetListSize(result);
-
-        auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-        std::vector<GeoLoop> holes;
-        std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-        DecodeWkbPolygon(input, polygon, outerVerts, holes, holesVerts);
-
-        return PolygonToCells(result, polygon, res, flags);
-      });
+template <class Output>
+static list_entry_t AppendCells(Vector &result,
+                                const std::vector<H3Index> &cells) {
+  H3StatsMaterialize materialize;
+  list_entry_t entry(ListVector::GetListSize(result), cells.size());
+  for (H3Index cell : cells) {
+    Output::PushBack(result, cell);
+  }
+  return entry;
 }
 
-static void PolygonWkbToCellsVarcharFunction(DataChunk &args,
-                                             ExpressionState &state,
-                                             Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKB strings
-  // will throw, others will return empty lists.
-  BinaryExecutor::Execute<string_t, int, list_entry_t>(
-      args.data[0], args.data[1], result, args.size(),
-      [&](string_t input, int res) {
-        GeoPolygon polygon = {0};
-        int32_t flags = 0;
-
-        uint64_t offset = ListVector::GetListSize(result);
+// Cells of a polygon at one resolution and flags
+struct PolygonCells {
+  int res;
+  uint32_t flags;
+  H3Error err;
+  std::vector<H3Index> cells;
+};
 
-        auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-        std::vector<GeoLoop> holes;
-        std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-        DecodeWkbPolygon(input, polygon, outerVerts, holes, holesVerts);
+// A decoded polygon, and its cells for the resolutions and flags it was
+// filled with. At most MAX_CELLS cells are kept over all fills, dropping the
+// oldest fills first; larger fills are not kept at all.
+struct PolygonCacheEntry {
+  static constexpr idx_t MAX_CELLS = 8192;
+  static constexpr idx_t MAX_FILLS = 4;
+
+  const PolygonCells *FindCells(int res, uint32_t flags) const {
+    for (auto &fill : fills) {
+      if (fill.res == res && fill.flags == flags) {
+        return &fill;
+      }
+    }
+    return nullptr;
+  }
 
-        return PolygonToCellsVarchar(result, polygon, res, flags);
-      });
-}
+  void AddCells(int res, uint32_t flags, H3Error err,
+                const std::vector<H3Index> &cells) {
+    if (!keepCells || cells.size() > MAX_CELLS) {
+      return;
+    }
+    while (fills.size() == MAX_FILLS ||
+           (!fills.empty() && cellCount + cells.size() > MAX_CELLS)) {
+      cellCount -= fills.front().cells.size();
+      fills.erase(fills.begin());
+    }
+    cellCount += cells.size();
+    fills.push_back({res, flags, err, cells});
+  }
 
-static list_entry_t
-PolygonWktToCellsExperimentalInnerFunction(string_t input, int res,
-                                           string_t flagsStr, Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKT strings
-  // will throw, others will return empty lists.
-  GeoPolygon polygon = {0};
+  void ClearCells() {
+    fills.clear();
+    cellCount = 0;
+  }
 
-  uint64_t offset = ListVector::GetListSize(result);
-  uint32_t flags = StringToFlags(flagsStr);
-  if (flags == UINT32_MAX) {
-    // Invalid flags input
-    return list_entry_t(offset, 0);
+  PolygonDecodeStatus status;
+  DecodedPolygons decoded;
+  std::vector<PolygonCells> fills;
+
+  // Bounding boxes of the loops of each part, computed when first needed
+  const std::vector<BBox> &BBoxes() {
+    if (bboxes.empty()) {
+      for (auto &polygon : decoded.polygons) {
+        size_t start = bboxes.size();
+        bboxes.resize(start + 1 + polygon.numHoles);
+        bboxesFromGeoPolygon(&polygon, &bboxes[start]);
+      }
+    }
+    return bboxes;
   }
+  std::vector<BBox> bboxes;
 
-  auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-  std::vector<GeoLoop> holes;
-  std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-  DecodeWktPolygon(input, polygon, outerVerts, holes, holesVerts);
+  // Key, for entries of the per thread cache
+  bool used = false;
+  hash_t hash = 0;
+  string input;
 
-  return PolygonToCellsExperimental(result, polygon, res, flags);
-}
+  bool Matches(hash_t hash_p, string_t input_p) const {
+    return used && hash == hash_p && input.size() == input_p.GetSize() &&
+           memcmp(input.data(), input_p.GetData(), input_p.GetSize()) == 0;
+  }
 
-static void PolygonWktToCellsExperimentalFunction(DataChunk &args,
-                                                  ExpressionState &state,
-                                                  Vector &result) {
-  TernaryExecutor::Execute<string_t, int, string_t, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, int res, string_t flagsStr) {
-        return PolygonWktToCellsExperimentalInnerFunction(input, res, flagsStr,
-                                                          result);
-      });
-}
+  // False for entries whose cells are not worth keeping
+  bool keepCells = true;
+  idx_t cellCount = 0;
+};
 
-static void PolygonWktToCellsExperimentalFunctionSwapped(DataChunk &args,
-                                                         ExpressionState &state,
-                                                         Vector &result) {
-  TernaryExecutor::Execute<string_t, string_t, int, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, string_t flagsStr, int res) {
-        return PolygonWktToCellsExperimentalInnerFunction(input, res, flagsStr,
-                                                          result);
-      });
-}
+typedef PolygonDecodeStatus (*polygon_decoder_t)(string_t input,
+                                                 DecodedPolygons &out);
 
-static list_entry_t PolygonWktToCellsExperimentalVarcharInnerFunction(
-    string_t input, int res, string_t flagsStr, Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKT strings
-  // will throw, others will return empty lists.
-  GeoPolygon polygon = {0};
+// Constant arguments, resolved once at bind time
+struct PolygonToCellsBindData : public FunctionData {
+  unique_ptr<FunctionData> Copy() const override {
+    return make_uniq<PolygonToCellsBindData>(*this);
+  }
 
-  uint64_t offset = ListVector::GetListSize(result);
-  uint32_t flags = StringToFlags(flagsStr);
-  if (flags == UINT32_MAX) {
-    // Invalid flags input
-    return list_entry_t(offset, 0);
+  bool Equals(const FunctionData &other_p) const override {
+    auto &other = other_p.Cast<PolygonToCellsBindData>();
+    return flags == other.flags && polygonInput == other.polygonInput &&
+           !polygon == !other.polygon;
   }
 
-  auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-  std::vector<GeoLoop> holes;
-  std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-  DecodeWktPolygon(input, polygon, outerVerts, holes, holesVerts);
+  // Resolved at bind time when constant, and otherwise UINT32_MAX
+  uint32_t flags = UINT32_MAX;
+  // Shared by copies, and not modified after bind
+  shared_ptr<DecodedPolygons> polygon;
+  string polygonInput;
+};
 
-  return PolygonToCellsExperimentalVarchar(result, polygon, res, flags);
-}
+// Each thread keeps the fills of the constant polygon, and a small direct
+// mapped cache of other polygons keyed by a hash of their bytes, so that
+// repeated polygons (say, from a small dimension table in a join) are
+// decoded once and filled once per resolution. A polygon only takes a cache
+// slot when it misses that slot twice in a row, so one-off polygons do not
+// evict repeated ones, and never when over MAX_INPUT_BYTES. This bounds the
+// cache to about CACHE_SIZE * (MAX_INPUT_BYTES + MAX_CELLS * 8) bytes (2
+// MiB) plus the decoded vertices. Polygons without a slot are decoded into a
+// single uncached entry.
+//
+// Callers that number their polygons (h3_points_in_polygons numbers its rows)
+// can look them up by that key instead. A keyed polygon is decoded on its
+// first miss, as the key already says it repeats, and the keyed polygons are
+// dropped together once their inputs add up to MAX_KEYED_BYTES.
+struct PolygonToCellsLocalState : public FunctionLocalState {
+  static constexpr idx_t CACHE_SIZE = 16;
+  static constexpr idx_t MAX_INPUT_BYTES = 64 * 1024;
+  static constexpr idx_t MAX_KEYED_BYTES = 16 * 1024 * 1024;
+
+  PolygonToCellsLocalState() {
+    uncached.keepCells = false;
+  }
 
-static void PolygonWktToCellsExperimentalVarcharFunction(DataChunk &args,
-                                                         ExpressionState &state,
-                                                         Vector &result) {
-  TernaryExecutor::Execute<string_t, int, string_t, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, int res, string_t flagsStr) {
-        return PolygonWktToCellsExperimentalVarcharInnerFunction(
-            input, res, flagsStr, result);
-      });
-}
+  static unique_ptr<FunctionLocalState>
+  Init(ExpressionState &state, const BoundFunctionExpression &expr,
+       FunctionData *bind_data) {
+    return make_uniq<PolygonToCellsLocalState>();
+  }
 
-static void PolygonWktToCellsExperimentalVarcharFunctionSwapped(
-    DataChunk &args, ExpressionState &state, Vector &result) {
-  TernaryExecutor::Execute<string_t, string_t, int, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, string_t flagsStr, int res) {
-        return PolygonWktToCellsExperimentalVarcharInnerFunction(
-            input, res, flagsStr, result);
-      });
-}
+  template <polygon_decoder_t Decode>
+  PolygonCacheEntry &Get(string_t input) {
+    auto hash = Hash(input.GetData(), input.GetSize());
+    auto slot = hash % CACHE_SIZE;
+    auto &entry = cache[slot];
+    if (entry.Matches(hash, input)) {
+      return entry;
+    }
+    bool admit = input.GetSize() <= MAX_INPUT_BYTES && seen[slot] == hash;
+    seen[slot] = hash;
+    if (uncached.Matches(hash, input)) {
+      if (!admit) {
+        return uncached;
+      }
+      // Seen again: the decoded polygon moves into its slot
+      std::swap(entry, uncached);
+      entry.keepCells = true;
+      uncached.keepCells = false;
+      uncached.used = false;
+      uncached.ClearCells();
+      return entry;
+    }
+    auto &target = admit ? entry : uncached;
+    target.used = true;
+    target.hash = hash;
+    target.input.assign(input.GetData(), input.GetSize());
+    target.ClearCells();
+    target.bboxes.clear();
+    target.decoded.Clear();
+    target.status = Decode(input, target.decoded);
+    return target;
+  }
 
-static list_entry_t PolygonWkbToCellsExperimentalVarcharInnerFunction(
-    string_t input, int res, string_t flagsStr, Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKB strings
-  // will throw, others will return empty lists.
+  // Rows with the same key must have the same input
+  template <polygon_decoder_t Decode>
+  PolygonCacheEntry &GetKeyed(int64_t key, string_t input) {
+    auto it = keyed.find(key);
+    if (it != keyed.end()) {
+      return it->second;
+    }
+    if (input.GetSize() > MAX_INPUT_BYTES) {
+      return Get<Decode>(input);
+    }
+    if (keyedBytes + input.GetSize() > MAX_KEYED_BYTES) {
+      keyed.clear();
+      keyedBytes = 0;
+    }
+    auto &entry = keyed[key];
+    entry.keepCells = false;
+    entry.status = Decode(input, entry.decoded);
+    keyedBytes += input.GetSize();
+    return entry;
+  }
 
-  uint64_t offset = ListVector::GetListSize(result);
+  PolygonCacheEntry constantPolygon;
+  PolygonCacheEntry cache[CACHE_SIZE];
+  // Hash of the last polygon that missed each slot
+  hash_t seen[CACHE_SIZE] = {};
+  PolygonCacheEntry uncached;
+  unordered_map<int64_t, PolygonCacheEntry> keyed;
+  idx_t keyedBytes = 0;
+  std::vector<H3Index> cells;
+};
 
-  uint32_t flags = StringToFlags(flagsStr);
-  if (flags == UINT32_MAX) {
-    // Invalid flags input
-    return list_entry_t(offset, 0);
+// Fills one polygon or multipolygon. Invalid input throws, and H3 errors
+// and WKT that is not a polygon give an empty list; in TRY mode (the h3_try_
+// functions) all of them give NULL instead.
+template <polygon_decoder_t Decode, class Algorithm, class Output, bool TRY>
+static list_entry_t PolygonToCellsRow(const PolygonToCellsBindData &bindData,
+                                      PolygonToCellsLocalState &lstate,
+                                      string_t input, int res, uint32_t flags,
+                                      Vector &result, ValidityMask &mask,
+                                      idx_t idx) {
+  PolygonCacheEntry *entry;
+  const DecodedPolygons *decoded;
+  if (bindData.polygon) {
+    entry = &lstate.constantPolygon;
+    decoded = bindData.polygon.get();
+  } else {
+    entry = &lstate.Get<Decode>(input);
+    decoded = &entry->decoded;
+    if (!entry->status.Ok()) {
+      if (TRY) {
+        mask.SetInvalid(idx);
+        return list_entry_t();
+      }
+      if (entry->status.NotPolygon()) {
+        return list_entry_t(ListVector::GetListSize(result), 0);
+      }
+      entry->status.Check();
+    }
   }
 
-  auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-  std::vector<GeoLoop> holes;
-  std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-  GeoPolygon polygon = {0};
-  DecodeWkbPolygon(input, polygon, outerVerts, holes, holesVerts);
-  return PolygonToCellsExperimentalVarchar(result, polygon, res, flags);
-}
-
-static void PolygonWkbToCellsExperimentalVarcharFunction(DataChunk &args,
-                                                         ExpressionState &state,
-                                                         Vector &result) {
-  TernaryExecutor::Execute<string_t, int, string_t, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, int res, string_t flagsStr) {
-        return PolygonWkbToCellsExperimentalVarcharInnerFunction(
-            input, res, flagsStr, result);
-      });
+  H3Error err;
+  const std::vector<H3Index> *cells = &lstate.cells;
+  auto cached = entry->FindCells(res, flags);
+  if (cached) {
+    err = cached->err;
+    cells = &cached->cells;
+  } else {
+    err = PolygonToCells<Algorithm>(*decoded, res, flags, lstate.cells);
+    if (err) {
+      lstate.cells.clear();
+    }
+    entry->AddCells(res, flags, err, lstate.cells);
+  }
+  if (err && TRY) {
+    mask.SetInvalid(idx);
+    return list_entry_t();
+  }
+  return AppendCells<Output>(result, *cells);
 }
 
-static void PolygonWkbToCellsExperimentalVarcharFunctionSwapped(
-    DataChunk &args, ExpressionState &state, Vector &result) {
-  TernaryExecutor::Execute<string_t, string_t, int, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, string_t flagsStr, int res) {
-        return PolygonWkbToCellsExperimentalVarcharInnerFunction(
-            input, res, flagsStr, result);
+// Marks functions without a flags argument
+static constexpr idx_t NO_FLAGS_ARG = DConstants::INVALID_INDEX;
+
+// The resolution and flags may be passed in either order, so RES_ARG and
+// FLAGS_ARG give their positions. The geometry is always the first argument.
+template <polygon_decoder_t Decode, class Algorithm, class Output, bool TRY,
+          idx_t RES_ARG, idx_t FLAGS_ARG>
+static void PolygonToCellsFunction(DataChunk &args, ExpressionState &state,
+                                   Vector &result) {
+  auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+  auto &bindData = func_expr.bind_info->Cast<PolygonToCellsBindData>();
+  auto &lstate = ExecuteFunctionState::GetFunctionState(state)
+                     ->Cast<PolygonToCellsLocalState>();
+  auto row = [&](string_t input, int res, uint32_t flags, ValidityMask &mask,
+                 idx_t idx) {
+    return PolygonToCellsRow<Decode, Algorithm, Output, TRY>(
+        bindData, lstate, input, res, flags, result, mask, idx);
+  };
+
+  if (FLAGS_ARG == NO_FLAGS_ARG || bindData.flags != UINT32_MAX) {
+    uint32_t flags = FLAGS_ARG == NO_FLAGS_ARG ? 0 : bindData.flags;
+    BinaryExecutor::ExecuteWithNulls<string_t, int, list_entry_t>(
+        args.data[0], args.data[RES_ARG], result, args.size(),
+        [&](string_t input, int res, ValidityMask &mask, idx_t idx) {
+          return row(input, res, flags, mask, idx);
+        });
+    return;
+  }
+  TernaryExecutor::ExecuteWithNulls<string_t, int, string_t, list_entry_t>(
+      args.data[0], args.data[RES_ARG], args.data[FLAGS_ARG], result,
+      args.size(),
+      [&](string_t input, int res, string_t flagsStr, ValidityMask &mask,
+          idx_t idx) {
+        uint32_t flags = StringToFlags(flagsStr);
+        if (flags == UINT32_MAX) {
+          // Invalid flags input
+          if (TRY) {
+            mask.SetInvalid(idx);
+          }
+          return list_entry_t(ListVector::GetListSize(result), 0);
+        }
+        return row(input, res, flags, mask, idx);
       });
 }
 
-static list_entry_t
-PolygonWkbToCellsExperimentalInnerFunction(string_t input, int res,
-                                           string_t flagsStr, Vector &result) {
-  // TODO: Note this function is not fully noexcept -- some invalid WKB strings
-  // will throw, others will return empty lists.
-
-  uint64_t offset = ListVector::GetListSize(result);
-
-  uint32_t flags = StringToFlags(flagsStr);
-  if (flags == UINT32_MAX) {
-    // Invalid flags input
-    return list_entry_t(offset, 0);
+// Resolves constant flags, and decodes a constant polygon. Invalid constant
+// flags are an error, except in TRY mode where they are left to the per row
+// kernel to return NULL. An invalid constant polygon is always left to the
+// kernel, so that it only fails if rows are actually filled.
+template <polygon_decoder_t Decode, bool TRY, idx_t FLAGS_ARG>
+static unique_ptr<FunctionData>
+PolygonToCellsBind(ClientContext &context, ScalarFunction &bound_function,
+                   vector<unique_ptr<Expression>> &arguments) {
+  auto result = make_uniq<PolygonToCellsBindData>();
+
+  Value flagsValue;
+  if (FLAGS_ARG != NO_FLAGS_ARG &&
+      TryGetConstantArgument(context, *arguments[FLAGS_ARG], flagsValue)) {
+    auto &flagsStr = StringValue::Get(flagsValue);
+    result->flags =
+        StringToFlags(string_t(flagsStr.c_str(), (uint32_t)flagsStr.size()));
+    if (result->flags == UINT32_MAX && !TRY) {
+      throw InvalidInputException(
+          StringUtil::Format("%s: invalid containment mode '%s'",
+                             bound_function.name, flagsStr));
+    }
   }
 
-  auto outerVerts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-  std::vector<GeoLoop> holes;
-  std::vector<duckdb::shared_ptr<std::vector<LatLng>>> holesVerts;
-  GeoPolygon polygon = {0};
-  DecodeWkbPolygon(input, polygon, outerVerts, holes, holesVerts);
-  return PolygonToCellsExperimental(result, polygon, res, flags);
-}
-
-static void PolygonWkbToCellsExperimentalFunction(DataChunk &args,
-                                                  ExpressionState &state,
-                                                  Vector &result) {
-  TernaryExecutor::Execute<string_t, int, string_t, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, int res, string_t flagsStr) {
-        return PolygonWkbToCellsExperimentalInnerFunction(input, res, flagsStr,
-                                                          result);
-      });
+  Value polygonValue;
+  if (TryGetConstantArgument(context, *arguments[0], polygonValue)) {
+    // Arguments are cast to the parameter types only after binding
+    polygonValue = polygonValue.DefaultCastAs(bound_function.arguments[0]);
+    auto &polygonStr = StringValue::Get(polygonValue);
+    auto polygon = make_shared_ptr<DecodedPolygons>();
+    auto status = Decode(
+        string_t(polygonStr.c_str(), (uint32_t)polygonStr.size()), *polygon);
+    if (status.Ok()) {
+      result->polygon = std::move(polygon);
+      result->polygonInput = polygonStr;
+    }
+  }
+  return std::move(result);
 }
 
-static void PolygonWkbToCellsExperimentalFunctionSwapped(DataChunk &args,
-                                                         ExpressionState &state,
-                                                         Vector &result) {
-  TernaryExecutor::Execute<string_t, string_t, int, list_entry_t>(
-      args.data[0], args.data[1], args.data[2], result, args.size(),
-      [&](string_t input, string_t flagsStr, int res) {
-        return PolygonWkbToCellsExperimentalInnerFunction(input, res, flagsStr,
-                                                          result);
-      });
+template <polygon_decoder_t Decode, class Algorithm, class Output, bool TRY,
+          idx_t RES_ARG, idx_t FLAGS_ARG>
+static ScalarFunction
+PolygonToCellsScalarFunction(vector<LogicalType> arguments,
+                             const LogicalType &resultType) {
+  ScalarFunction fun(
+      std::move(arguments), resultType,
+      PolygonToCellsFunction<Decode, Algorithm, Output, TRY, RES_ARG,
+                             FLAGS_ARG>,
+      PolygonToCellsBind<Decode, TRY, FLAGS_ARG>);
+  fun.init_local_state = PolygonToCellsLocalState::Init;
+  return fun;
 }
 
 CreateScalarFunctionInfo H3Functions::GetCellsToMultiPolygonWktFunction() {
@@ -585,92 +703,509 @@ CreateScalarFunctionInfo H3Functions::GetCellsToMultiPolygonWkbFunction() {
   return CreateScalarFunctionInfo(funcs);
 }
 
-CreateScalarFunctionInfo H3Functions::GetPolygonWktToCellsFunction() {
-  // TODO: Expose flags
-  return CreateScalarFunctionInfo(ScalarFunction(
-      "h3_polygon_wkt_to_cells", {LogicalType::VARCHAR, LogicalType::INTEGER},
-      LogicalType::LIST(LogicalType::UBIGINT), PolygonWktToCellsFunction));
+// Decodes each WKB (multi)polygon without filling it, writing
+// STRUCT(error UINTEGER, position UBIGINT). error is the H3Error code of the
+// input (0 when it decodes), and position the byte offset at which decoding
+// failed, or NULL.
+static void PolygonValidateWkbFunction(DataChunk &args, ExpressionState &state,
+                                       Vector &result) {
+  auto count = args.size();
+  UnifiedVectorFormat input_data;
+  args.data[0].ToUnifiedFormat(count, input_data);
+  auto inputs = UnifiedVectorFormat::GetData<string_t>(input_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto &result_validity = FlatVector::Validity(result);
+  auto &error_vector = *StructVector::GetEntries(result)[0];
+  auto &position_vector = *StructVector::GetEntries(result)[1];
+  auto error_data = FlatVector::GetData<uint32_t>(error_vector);
+  auto position_data = FlatVector::GetData<uint64_t>(position_vector);
+
+  DecodedPolygons decoded;
+  for (idx_t i = 0; i < count; i++) {
+    auto input_index = input_data.sel->get_index(i);
+    if (!input_data.validity.RowIsValid(input_index)) {
+      result_validity.SetInvalid(i);
+      FlatVector::SetNull(error_vector, i, true);
+      FlatVector::SetNull(position_vector, i, true);
+      continue;
+    }
+    decoded.Clear();
+    auto status = DecodeWkbPolygon(inputs[input_index], decoded);
+    error_data[i] = status.Code();
+    if (status.Ok()) {
+      FlatVector::SetNull(position_vector, i, true);
+    } else {
+      position_data[i] = status.position;
+    }
+  }
+
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(count);
 }
 
-CreateScalarFunctionInfo H3Functions::GetPolygonWktToCellsVarcharFunction() {
-  // TODO: Expose flags
-  return CreateScalarFunctionInfo(
-      ScalarFunction("h3_polygon_wkt_to_cells_string",
-                     {LogicalType::VARCHAR, LogicalType::INTEGER},
-                     LogicalType::LIST(LogicalType::VARCHAR),
-                     PolygonWktToCellsVarcharFunction));
+// Compact covering of a polygon for point lookups at res. Interior cells
+// are its compact CONTAINMENT_FULL covering, so every point in them is in the
+// polygon. Boundary cells cover the rest of its CONTAINMENT_OVERLAPPING
+// covering, and their points need an exact test. Boundary cells are split
+// into their children until none holds an interior cell, so that no cell of
+// the covering contains another, and a point is in at most one of them.
+static H3Error PolygonToCovering(const DecodedPolygons &decoded, int res,
+                                 std::vector<H3Index> &interior,
+                                 std::vector<H3Index> &boundary) {
+  std::vector<H3Index> overlap;
+  H3Error err = PolygonToCells<PolygonToCellsCompactAlgorithm>(
+      decoded, res, CONTAINMENT_FULL, interior);
+  if (err) {
+    return err;
+  }
+  err = PolygonToCells<PolygonToCellsCompactAlgorithm>(
+      decoded, res, CONTAINMENT_OVERLAPPING, overlap);
+  if (err) {
+    return err;
+  }
+
+  unordered_set<H3Index> interiorSet(interior.begin(), interior.end());
+  // Strict ancestors of the interior cells
+  unordered_set<H3Index> interiorParents;
+  for (H3Index cell : interior) {
+    for (int parentRes = 0; parentRes < getResolution(cell); parentRes++) {
+      H3Index parent;
+      if (cellToParent(cell, parentRes, &parent) == E_SUCCESS) {
+        interiorParents.insert(parent);
+      }
+    }
+  }
+
+  boundary.clear();
+  std::vector<H3Index> children;
+  while (!overlap.empty()) {
+    H3Index cell = overlap.back();
+    overlap.pop_back();
+    int cellRes = getResolution(cell);
+    bool isInterior = false;
+    for (int parentRes = 0; parentRes <= cellRes && !isInterior;
+         parentRes++) {
+      H3Index parent;
+      isInterior = cellToParent(cell, parentRes, &parent) == E_SUCCESS &&
+                   interiorSet.count(parent);
+    }
+    if (isInterior) {
+      continue;
+    }
+    if (!interiorParents.count(cell)) {
+      boundary.push_back(cell);
+      continue;
+    }
+    int64_t numChildren;
+    err = cellToChildrenSize(cell, cellRes + 1, &numChildren);
+    if (err) {
+      return err;
+    }
+    children.resize(numChildren);
+    err = cellToChildren(cell, cellRes + 1, children.data());
+    if (err) {
+      return err;
+    }
+    for (H3Index child : children) {
+      if (child != H3_NULL) {
+        overlap.push_back(child);
+      }
+    }
+  }
+  return E_SUCCESS;
 }
 
-CreateScalarFunctionInfo H3Functions::GetPolygonWkbToCellsFunction() {
-  // TODO: Expose flags
-  return CreateScalarFunctionInfo(ScalarFunction(
-      "h3_polygon_wkb_to_cells", {LogicalType::BLOB, LogicalType::INTEGER},
-      LogicalType::LIST(LogicalType::UBIGINT), PolygonWkbToCellsFunction));
+// Writes LIST(STRUCT(cell UBIGINT, interior BOOLEAN)) coverings. Invalid
+// input throws, and H3 errors give NULL.
+static void PolygonToCoveringFunction(DataChunk &args, ExpressionState &state,
+                                      Vector &result) {
+  DecodedPolygons decoded;
+  std::vector<H3Index> interior;
+  std::vector<H3Index> boundary;
+  BinaryExecutor::ExecuteWithNulls<string_t, int, list_entry_t>(
+      args.data[0], args.data[1], result, args.size(),
+      [&](string_t input, int res, ValidityMask &mask, idx_t idx) {
+        decoded.Clear();
+        DecodeWkbPolygon(input, decoded).Check();
+        if (PolygonToCovering(decoded, res, interior, boundary)) {
+          mask.SetInvalid(idx);
+          return list_entry_t();
+        }
+
+        H3StatsMaterialize materialize;
+        idx_t offset = ListVector::GetListSize(result);
+        idx_t length = interior.size() + boundary.size();
+        ListVector::Reserve(result, offset + length);
+        auto &entries = StructVector::GetEntries(ListVector::GetEntry(result));
+        auto cells = FlatVector::GetData<uint64_t>(*entries[0]);
+        auto interiors = FlatVector::GetData<bool>(*entries[1]);
+        idx_t i = offset;
+        for (H3Index cell : interior) {
+          cells[i] = cell;
+          interiors[i++] = true;
+        }
+        for (H3Index cell : boundary) {
+          cells[i] = cell;
+          interiors[i++] = false;
+        }
+        ListVector::SetListSize(result, offset + length);
+        return list_entry_t(offset, length);
+      });
 }
 
-CreateScalarFunctionInfo H3Functions::GetPolygonWkbToCellsVarcharFunction() {
+// Exact point in polygon test, for the boundary cells of a covering. Points
+// on the boundary are assigned the way H3 assigns cell centers.
+static bool DecodedPolygonContainsPoint(PolygonCacheEntry &entry, double lat,
+                                        double lng) {
+  LatLng point = {.lat = degsToRads(lat), .lng = degsToRads(lng)};
+  auto &bboxes = entry.BBoxes();
+  idx_t bboxIndex = 0;
+  for (auto &polygon : entry.decoded.polygons) {
+    if (pointInsidePolygon(&polygon, &bboxes[bboxIndex], &point)) {
+      return true;
+    }
+    bboxIndex += 1 + polygon.numHoles;
+  }
+  return false;
+}
+
+static void PolygonContainsPointFunction(DataChunk &args,
+                                         ExpressionState &state,
+                                         Vector &result) {
+  auto &lstate = ExecuteFunctionState::GetFunctionState(state)
+                     ->Cast<PolygonToCellsLocalState>();
+  TernaryExecutor::Execute<string_t, double, double, bool>(
+      args.data[0], args.data[1], args.data[2], result, args.size(),
+      [&](string_t input, double lat, double lng) {
+        auto &entry = lstate.Get<DecodeWkbPolygon>(input);
+        entry.status.Check();
+        return DecodedPolygonContainsPoint(entry, lat, lng);
+      });
+}
+
+// The point in polygon test with a key for the polygon, so that the polygon
+// is looked up by key rather than by hashing its bytes.
+static void PolygonContainsPointKeyedFunction(DataChunk &args,
+                                              ExpressionState &state,
+                                              Vector &result) {
+  auto &lstate = ExecuteFunctionState::GetFunctionState(state)
+                     ->Cast<PolygonToCellsLocalState>();
+  auto count = args.size();
+  UnifiedVectorFormat input_data;
+  args.data[0].ToUnifiedFormat(count, input_data);
+  UnifiedVectorFormat lat_data;
+  args.data[1].ToUnifiedFormat(count, lat_data);
+  UnifiedVectorFormat lng_data;
+  args.data[2].ToUnifiedFormat(count, lng_data);
+  UnifiedVectorFormat key_data;
+  args.data[3].ToUnifiedFormat(count, key_data);
+  auto inputs = UnifiedVectorFormat::GetData<string_t>(input_data);
+  auto lats = UnifiedVectorFormat::GetData<double>(lat_data);
+  auto lngs = UnifiedVectorFormat::GetData<double>(lng_data);
+  auto keys = UnifiedVectorFormat::GetData<int64_t>(key_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_data = FlatVector::GetData<bool>(result);
+  auto &result_validity = FlatVector::Validity(result);
+  for (idx_t i = 0; i < count; i++) {
+    auto input_index = input_data.sel->get_index(i);
+    auto lat_index = lat_data.sel->get_index(i);
+    auto lng_index = lng_data.sel->get_index(i);
+    auto key_index = key_data.sel->get_index(i);
+    if (!input_data.validity.RowIsValid(input_index) ||
+        !lat_data.validity.RowIsValid(lat_index) ||
+        !lng_data.validity.RowIsValid(lng_index)) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+    // Without a key, the polygon is looked up by its bytes
+    auto &entry =
+        key_data.validity.RowIsValid(key_index)
+            ? lstate.GetKeyed<DecodeWkbPolygon>(keys[key_index],
+                                                inputs[input_index])
+            : lstate.Get<DecodeWkbPolygon>(inputs[input_index]);
+    entry.status.Check();
+    result_data[i] =
+        DecodedPolygonContainsPoint(entry, lats[lat_index], lngs[lng_index]);
+  }
+
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(count);
+}
+
+template <polygon_decoder_t Decode, class Output, bool TRY>
+static CreateScalarFunctionInfo
+PolygonToCellsInfo(const string &name, const vector<LogicalType> &inputTypes,
+                   const LogicalType &cellType) {
   // TODO: Expose flags
-  return CreateScalarFunctionInfo(
-      ScalarFunction("h3_polygon_wkb_to_cells_string",
-                     {LogicalType::BLOB, LogicalType::INTEGER},
-                     LogicalType::LIST(LogicalType::VARCHAR),
-                     PolygonWkbToCellsVarcharFunction));
+  ScalarFunctionSet funcs(name);
+  for (auto &inputType : inputTypes) {
+    funcs.AddFunction(
+        PolygonToCellsScalarFunction<Decode, PolygonToCellsAlgorithm, Output,
+                                     TRY, 1, NO_FLAGS_ARG>(
+            {inputType, LogicalType::INTEGER}, LogicalType::LIST(cellType)));
+  }
+  return CreateScalarFunctionInfo(funcs);
 }
 
-CreateScalarFunctionInfo
-H3Functions::GetPolygonWktToCellsExperimentalFunction() {
-  ScalarFunctionSet funcs("h3_polygon_wkt_to_cells_experimental");
-  funcs.AddFunction(ScalarFunction(
-      {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR},
-      LogicalType::LIST(LogicalType::UBIGINT),
-      PolygonWktToCellsExperimentalFunction));
-  funcs.AddFunction(ScalarFunction(
-      {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::INTEGER},
-      LogicalType::LIST(LogicalType::UBIGINT),
-      PolygonWktToCellsExperimentalFunctionSwapped));
+template <polygon_decoder_t Decode, class Output, bool TRY>
+static CreateScalarFunctionInfo
+PolygonToCellsExperimentalInfo(const string &name,
+                               const vector<LogicalType> &inputTypes,
+                               const LogicalType &cellType) {
+  ScalarFunctionSet funcs(name);
+  for (auto &inputType : inputTypes) {
+    funcs.AddFunction(
+        PolygonToCellsScalarFunction<Decode,
+                                     PolygonToCellsExperimentalAlgorithm,
+                                     Output, TRY, 1, 2>(
+            {inputType, LogicalType::INTEGER, LogicalType::VARCHAR},
+            LogicalType::LIST(cellType)));
+    funcs.AddFunction(
+        PolygonToCellsScalarFunction<Decode,
+                                     PolygonToCellsExperimentalAlgorithm,
+                                     Output, TRY, 2, 1>(
+            {inputType, LogicalType::VARCHAR, LogicalType::INTEGER},
+            LogicalType::LIST(cellType)));
+  }
   return CreateScalarFunctionInfo(funcs);
 }
 
+// Polygons are read as WKT from VARCHAR, and as WKB from BLOB or GEOMETRY,
+// which holds WKB in place and so is decoded without a conversion.
+static vector<LogicalType> WktInputTypes() { return {LogicalType::VARCHAR}; }
+
+static vector<LogicalType> WkbInputTypes() {
+  return {LogicalType::BLOB, LogicalType::GEOMETRY()};
+}
+
 CreateScalarFunctionInfo
-H3Functions::GetPolygonWkbToCellsExperimentalFunction() {
-  ScalarFunctionSet funcs("h3_polygon_wkb_to_cells_experimental");
+H3Functions::GetCellsToMultiPolygonGeometryFunction() {
+  ScalarFunctionSet funcs("h3_cells_to_multi_polygon_geometry");
   funcs.AddFunction(ScalarFunction(
-      {LogicalType::BLOB, LogicalType::INTEGER, LogicalType::VARCHAR},
-      LogicalType::LIST(LogicalType::UBIGINT),
-      PolygonWkbToCellsExperimentalFunction));
+      {LogicalType::LIST(LogicalType::VARCHAR)}, LogicalType::GEOMETRY(),
+      CellsToMultiPolygonFunction<string_t,
+                                  CellsToMultiPolygonVarcharInputOperator,
+                                  WkbEncoder, true>));
   funcs.AddFunction(ScalarFunction(
-      {LogicalType::BLOB, LogicalType::VARCHAR, LogicalType::INTEGER},
-      LogicalType::LIST(LogicalType::UBIGINT),
-      PolygonWkbToCellsExperimentalFunctionSwapped));
+      {LogicalType::LIST(LogicalType::UBIGINT)}, LogicalType::GEOMETRY(),
+      CellsToMultiPolygonFunction<uint64_t, CellsToMultiPolygonInputOperator,
+                                  WkbEncoder, true>));
+  funcs.AddFunction(ScalarFunction(
+      {LogicalType::LIST(LogicalType::BIGINT)}, LogicalType::GEOMETRY(),
+      CellsToMultiPolygonFunction<int64_t, CellsToMultiPolygonInputOperator,
+                                  WkbEncoder, true>));
   return CreateScalarFunctionInfo(funcs);
 }
 
+CreateScalarFunctionInfo H3Functions::GetPolygonWktToCellsFunction() {
+  return PolygonToCellsInfo<DecodeWktPolygon, CellsUbigintOutput, false>(
+      "h3_polygon_wkt_to_cells", WktInputTypes(), LogicalType::UBIGINT);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonWktToCellsVarcharFunction() {
+  return PolygonToCellsInfo<DecodeWktPolygon, CellsVarcharOutput, false>(
+      "h3_polygon_wkt_to_cells_string", WktInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo
+H3Functions::GetPolygonWktToCellsExperimentalFunction() {
+  return PolygonToCellsExperimentalInfo<DecodeWktPolygon,
+                                        CellsUbigintOutput, false>(
+      "h3_polygon_wkt_to_cells_experimental",
+      WktInputTypes(), LogicalType::UBIGINT);
+}
+
 CreateScalarFunctionInfo
 H3Functions::GetPolygonWktToCellsExperimentalVarcharFunction() {
-  ScalarFunctionSet funcs("h3_polygon_wkt_to_cells_experimental_string");
-  funcs.AddFunction(ScalarFunction(
-      {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::VARCHAR},
-      LogicalType::LIST(LogicalType::VARCHAR),
-      PolygonWktToCellsExperimentalVarcharFunction));
-  funcs.AddFunction(ScalarFunction(
-      {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::INTEGER},
-      LogicalType::LIST(LogicalType::VARCHAR),
-      PolygonWktToCellsExperimentalVarcharFunctionSwapped));
-  return CreateScalarFunctionInfo(funcs);
+  return PolygonToCellsExperimentalInfo<DecodeWktPolygon,
+                                        CellsVarcharOutput, false>(
+      "h3_polygon_wkt_to_cells_experimental_string",
+      WktInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonWkbToCellsFunction() {
+  return PolygonToCellsInfo<DecodeWkbPolygon, CellsUbigintOutput, false>(
+      "h3_polygon_wkb_to_cells", WkbInputTypes(), LogicalType::UBIGINT);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonWkbToCellsVarcharFunction() {
+  return PolygonToCellsInfo<DecodeWkbPolygon, CellsVarcharOutput, false>(
+      "h3_polygon_wkb_to_cells_string", WkbInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo
+H3Functions::GetPolygonWkbToCellsExperimentalFunction() {
+  return PolygonToCellsExperimentalInfo<DecodeWkbPolygon,
+                                        CellsUbigintOutput, false>(
+      "h3_polygon_wkb_to_cells_experimental",
+      WkbInputTypes(), LogicalType::UBIGINT);
 }
 
 CreateScalarFunctionInfo
 H3Functions::GetPolygonWkbToCellsExperimentalVarcharFunction() {
-  ScalarFunctionSet funcs("h3_polygon_wkb_to_cells_experimental_string");
-  funcs.AddFunction(ScalarFunction(
-      {LogicalType::BLOB, LogicalType::INTEGER, LogicalType::VARCHAR},
-      LogicalType::LIST(LogicalType::VARCHAR),
-      PolygonWkbToCellsExperimentalVarcharFunction));
-  funcs.AddFunction(ScalarFunction(
-      {LogicalType::BLOB, LogicalType::VARCHAR, LogicalType::INTEGER},
-      LogicalType::LIST(LogicalType::VARCHAR),
-      PolygonWkbToCellsExperimentalVarcharFunctionSwapped));
+  return PolygonToCellsExperimentalInfo<DecodeWkbPolygon,
+                                        CellsVarcharOutput, false>(
+      "h3_polygon_wkb_to_cells_experimental_string",
+      WkbInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonWkbToCellsCompactFunction() {
+  ScalarFunctionSet funcs("h3_polygon_wkb_to_cells_compact");
+  for (auto &inputType : WkbInputTypes()) {
+    funcs.AddFunction(
+        PolygonToCellsScalarFunction<DecodeWkbPolygon,
+                                     PolygonToCellsCompactAlgorithm,
+                                     CellsUbigintOutput, false, 1, 2>(
+            {inputType, LogicalType::INTEGER, LogicalType::VARCHAR},
+            LogicalType::LIST(LogicalType::UBIGINT)));
+  }
   return CreateScalarFunctionInfo(funcs);
 }
 
+CreateScalarFunctionInfo H3Functions::GetTryPolygonWktToCellsFunction() {
+  return PolygonToCellsInfo<DecodeWktPolygon, CellsUbigintOutput, true>(
+      "h3_try_polygon_wkt_to_cells", WktInputTypes(), LogicalType::UBIGINT);
+}
+
+CreateScalarFunctionInfo H3Functions::GetTryPolygonWktToCellsVarcharFunction() {
+  return PolygonToCellsInfo<DecodeWktPolygon, CellsVarcharOutput, true>(
+      "h3_try_polygon_wkt_to_cells_string",
+      WktInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo
+H3Functions::GetTryPolygonWktToCellsExperimentalFunction() {
+  return PolygonToCellsExperimentalInfo<DecodeWktPolygon,
+                                        CellsUbigintOutput, true>(
+      "h3_try_polygon_wkt_to_cells_experimental",
+      WktInputTypes(), LogicalType::UBIGINT);
+}
+
+CreateScalarFunctionInfo
+H3Functions::GetTryPolygonWktToCellsExperimentalVarcharFunction() {
+  return PolygonToCellsExperimentalInfo<DecodeWktPolygon,
+                                        CellsVarcharOutput, true>(
+      "h3_try_polygon_wkt_to_cells_experimental_string",
+      WktInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo H3Functions::GetTryPolygonWkbToCellsFunction() {
+  return PolygonToCellsInfo<DecodeWkbPolygon, CellsUbigintOutput, true>(
+      "h3_try_polygon_wkb_to_cells", WkbInputTypes(), LogicalType::UBIGINT);
+}
+
+CreateScalarFunctionInfo H3Functions::GetTryPolygonWkbToCellsVarcharFunction() {
+  return PolygonToCellsInfo<DecodeWkbPolygon, CellsVarcharOutput, true>(
+      "h3_try_polygon_wkb_to_cells_string",
+      WkbInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo
+H3Functions::GetTryPolygonWkbToCellsExperimentalFunction() {
+  return PolygonToCellsExperimentalInfo<DecodeWkbPolygon,
+                                        CellsUbigintOutput, true>(
+      "h3_try_polygon_wkb_to_cells_experimental",
+      WkbInputTypes(), LogicalType::UBIGINT);
+}
+
+CreateScalarFunctionInfo
+H3Functions::GetTryPolygonWkbToCellsExperimentalVarcharFunction() {
+  return PolygonToCellsExperimentalInfo<DecodeWkbPolygon,
+                                        CellsVarcharOutput, true>(
+      "h3_try_polygon_wkb_to_cells_experimental_string",
+      WkbInputTypes(), LogicalType::VARCHAR);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonWkbToCoveringFunction() {
+  child_list_t<LogicalType> children;
+  children.emplace_back("cell", LogicalType::UBIGINT);
+  children.emplace_back("interior", LogicalType::BOOLEAN);
+  auto resultType = LogicalType::LIST(LogicalType::STRUCT(children));
+  ScalarFunctionSet funcs("h3_polygon_wkb_to_covering");
+  for (auto &inputType : WkbInputTypes()) {
+    funcs.AddFunction(ScalarFunction({inputType, LogicalType::INTEGER},
+                                     resultType, PolygonToCoveringFunction));
+  }
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonWkbContainsPointFunction() {
+  ScalarFunctionSet funcs("h3_polygon_wkb_contains_point");
+  for (auto &inputType : WkbInputTypes()) {
+    ScalarFunction fun({inputType, LogicalType::DOUBLE, LogicalType::DOUBLE},
+                       LogicalType::BOOLEAN, PolygonContainsPointFunction);
+    fun.init_local_state = PolygonToCellsLocalState::Init;
+    funcs.AddFunction(fun);
+
+    ScalarFunction keyed({inputType, LogicalType::DOUBLE, LogicalType::DOUBLE,
+                          LogicalType::BIGINT},
+                         LogicalType::BOOLEAN,
+                         PolygonContainsPointKeyedFunction);
+    keyed.init_local_state = PolygonToCellsLocalState::Init;
+    funcs.AddFunction(keyed);
+  }
+  return CreateScalarFunctionInfo(funcs);
+}
+
+// Joins points (id, lat, lng) to the polygons (id, geom) containing them. The
+// polygon side is reduced to the compact coverings of
+// h3_polygon_wkb_to_covering, built in parallel by the hash join, and each
+// point streams through it, computing its cell once and probing only the
+// ancestors at the resolutions the coverings have. Points in boundary cells
+// are tested exactly as they stream past, with the polygon row number as the
+// key of the decode cache, so each thread decodes a polygon once.
+// Polygons are numbered so that rows with the same id are kept apart.
+static const DefaultTableMacro POINTS_IN_POLYGONS_MACRO = {
+    DEFAULT_SCHEMA,
+    "h3_points_in_polygons",
+    {"points", "polygons", "res", nullptr},
+    {{nullptr, nullptr}},
+    R"(
+WITH polygon AS MATERIALIZED (
+  SELECT row_number() OVER () AS polygon_row, id, geom
+  FROM query_table(polygons)
+), covering AS MATERIALIZED (
+  SELECT polygon_row, id,
+    unnest(h3_polygon_wkb_to_covering(geom, res), recursive := true)
+  FROM polygon
+), candidate AS (
+  SELECT probe.id AS point_id, probe.lat, probe.lng, covering.polygon_row,
+    covering.id AS polygon_id, covering.interior
+  FROM (
+    SELECT id, lat, lng,
+      unnest(h3_cell_to_ancestors(h3_latlng_to_cell(lat, lng, res), (
+        SELECT bit_or(1 << h3_get_resolution(cell)) FROM covering
+      ))) AS cell
+    FROM query_table(points)
+  ) probe
+  JOIN covering USING (cell)
+)
+SELECT point_id, polygon_id FROM candidate WHERE interior
+UNION ALL
+SELECT point_id, polygon_id
+FROM candidate JOIN polygon USING (polygon_row)
+WHERE NOT interior
+  AND h3_polygon_wkb_contains_point(polygon.geom, lat, lng, polygon_row)
+)"};
+
+unique_ptr<CreateMacroInfo> H3Functions::GetPointsInPolygonsMacro() {
+  return DefaultTableFunctionGenerator::CreateTableMacroInfo(
+      POINTS_IN_POLYGONS_MACRO);
+}
+
+CreateScalarFunctionInfo H3Functions::GetPolygonValidateWkbFunction() {
+  child_list_t<LogicalType> children;
+  children.emplace_back("error", LogicalType::UINTEGER);
+  children.emplace_back("position", LogicalType::UBIGINT);
+  return CreateScalarFunctionInfo(ScalarFunction(
+      "h3_polygon_validate_wkb", {LogicalType::BLOB},
+      LogicalType::STRUCT(children), PolygonValidateWkbFunction));
+}
+
 } // namespace duckdb
@@ -0,0 +1,548 @@
+#include "h3_common.hpp"
+#include "h3_functions.hpp"
+
+#include "duckdb/common/exception.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+// H3SET values are BLOBs: a version byte, the number of cells, and then the
+// cells in ascending order, in runs of one resolution. Each run starts with
+// its resolution, number of cells and size in bytes, so readers can skip
+// runs of other resolutions. The cells follow without their unused digits,
+// each as a varint delta from the previous one. Index order sorts cells by
+// resolution, then base cell and digits, so nearby cells have small deltas:
+// consecutive siblings take one byte.
+static constexpr uint8_t H3SET_VERSION = 1;
+
+// The bits above the resolution of every valid cell: mode 1 and no reserved
+// bits
+static constexpr H3Index CELL_HIGH_BITS = 0x08;
+
+static int UnusedBits(int res) { return 3 * (MAX_H3_RES - res); }
+
+static void PutVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(char(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(char(value));
+}
+
+static void ThrowInvalidSet() { throw InvalidInputException("Invalid H3SET"); }
+
+// Appends cells to an H3SET. Cells must be valid, and added in ascending
+// order without repeats.
+class H3SetWriter {
+public:
+  void Reset() {
+    body.clear();
+    run.clear();
+    count = 0;
+    runCount = 0;
+    runRes = -1;
+  }
+
+  void Add(H3Index cell) {
+    int res = int((cell >> 52) & 0xF);
+    if (res != runRes) {
+      FlushRun();
+      runRes = res;
+      previous = 0;
+    }
+    H3Index digits = cell >> UnusedBits(res);
+    PutVarint(run, digits - previous);
+    previous = digits;
+    runCount++;
+    count++;
+  }
+
+  string_t Finish(Vector &result) {
+    FlushRun();
+    std::string header;
+    header.push_back(char(H3SET_VERSION));
+    PutVarint(header, count);
+    auto blob = StringVector::EmptyString(result, header.size() + body.size());
+    auto data = blob.GetDataWriteable();
+    memcpy(data, header.data(), header.size());
+    memcpy(data + header.size(), body.data(), body.size());
+    blob.Finalize();
+    return blob;
+  }
+
+private:
+  void FlushRun() {
+    if (!runCount) {
+      return;
+    }
+    body.push_back(char(runRes));
+    PutVarint(body, runCount);
+    PutVarint(body, run.size());
+    body += run;
+    run.clear();
+    runCount = 0;
+  }
+
+  std::string body;
+  std::string run;
+  uint64_t count = 0;
+  uint64_t runCount = 0;
+  int runRes = -1;
+  H3Index previous = 0;
+};
+
+// Decodes the cells of an H3SET in ascending order, without materializing
+// them. Throws on malformed input.
+class H3SetReader {
+public:
+  explicit H3SetReader(string_t blob)
+      : pos(const_data_ptr_cast(blob.GetData())), end(pos + blob.GetSize()),
+        runEnd(pos) {
+    if (pos == end || *pos++ != H3SET_VERSION) {
+      ThrowInvalidSet();
+    }
+    count = GetVarint(end);
+    // Each cell takes at least a byte
+    if (count > uint64_t(end - pos)) {
+      ThrowInvalidSet();
+    }
+    runEnd = pos;
+  }
+
+  uint64_t Size() const { return count; }
+
+  bool Next(H3Index &cell) {
+    while (!runRemaining) {
+      if (!NextRun()) {
+        return false;
+      }
+    }
+    uint64_t delta = GetVarint(runEnd);
+    if ((delta == 0 && runRemaining != runCount) ||
+        delta > maxDigits - previous) {
+      ThrowInvalidSet();
+    }
+    previous += delta;
+    runRemaining--;
+    if (!runRemaining && pos != runEnd) {
+      ThrowInvalidSet();
+    }
+    int unusedBits = UnusedBits(runRes);
+    cell = (previous << unusedBits) | ((H3Index(1) << unusedBits) - 1);
+    if ((cell >> 56) != CELL_HIGH_BITS ||
+        int((cell >> 52) & 0xF) != runRes) {
+      ThrowInvalidSet();
+    }
+    return true;
+  }
+
+  // Skips ahead to the run of cells of res, returning false if there is
+  // none
+  bool SeekResolution(int res) {
+    while (runRes != res || !runRemaining) {
+      if (runRes > res || !NextRun()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  uint64_t GetVarint(const_data_ptr_t limit) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos == limit) {
+        break;
+      }
+      uint8_t byte = *pos++;
+      value |= uint64_t(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    ThrowInvalidSet();
+    return 0;
+  }
+
+  // Moves to the start of the next run, skipping what is left of this one
+  bool NextRun() {
+    pos = runEnd;
+    if (pos == end) {
+      if (seen != count) {
+        ThrowInvalidSet();
+      }
+      runRemaining = 0;
+      return false;
+    }
+    int res = *pos++;
+    if (res > MAX_H3_RES || res <= runRes) {
+      ThrowInvalidSet();
+    }
+    runRes = res;
+    runCount = GetVarint(end);
+    uint64_t runBytes = GetVarint(end);
+    if (!runCount || runCount > count - seen ||
+        runBytes > uint64_t(end - pos)) {
+      ThrowInvalidSet();
+    }
+    seen += runCount;
+    runRemaining = runCount;
+    runEnd = pos + runBytes;
+    previous = 0;
+    maxDigits = UINT64_MAX >> UnusedBits(runRes);
+    return true;
+  }
+
+  const_data_ptr_t pos;
+  const_data_ptr_t end;
+  const_data_ptr_t runEnd;
+  uint64_t count = 0;
+  uint64_t seen = 0;
+  int runRes = -1;
+  uint64_t runCount = 0;
+  uint64_t runRemaining = 0;
+  H3Index previous = 0;
+  H3Index maxDigits = 0;
+};
+
+// Sorts and deduplicates the cells, and writes them as an H3SET
+static string_t CellsToSet(vector<H3Index> &cells, H3SetWriter &writer,
+                           Vector &result) {
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+  writer.Reset();
+  for (auto cell : cells) {
+    writer.Add(cell);
+  }
+  return writer.Finish(result);
+}
+
+static void CellsToSetFunction(DataChunk &args, ExpressionState &state,
+                               Vector &result) {
+  auto count = args.size();
+  Vector &lists = args.data[0];
+  auto lists_size = ListVector::GetListSize(lists);
+  auto &child_vector = ListVector::GetEntry(lists);
+
+  UnifiedVectorFormat child_data;
+  child_vector.ToUnifiedFormat(lists_size, child_data);
+  auto children = UnifiedVectorFormat::GetData<H3Index>(child_data);
+
+  H3SetWriter writer;
+  vector<H3Index> cells;
+  UnaryExecutor::ExecuteWithNulls<list_entry_t, string_t>(
+      lists, result, count,
+      [&](const list_entry_t &list, ValidityMask &mask, idx_t idx) {
+        cells.clear();
+        for (idx_t j = list.offset; j < list.offset + list.length; j++) {
+          auto child_index = child_data.sel->get_index(j);
+          if (!child_data.validity.RowIsValid(child_index)) {
+            continue;
+          }
+          H3Index cell = children[child_index];
+          if (!isValidCell(cell)) {
+            mask.SetInvalid(idx);
+            return string_t();
+          }
+          cells.push_back(cell);
+        }
+        return CellsToSet(cells, writer, result);
+      });
+}
+
+static void SetToCellsFunction(DataChunk &args, ExpressionState &state,
+                               Vector &result) {
+  UnaryExecutor::Execute<string_t, list_entry_t>(
+      args.data[0], result, args.size(), [&](string_t blob) {
+        H3SetReader reader(blob);
+        idx_t offset = ListVector::GetListSize(result);
+        ListVector::Reserve(result, offset + reader.Size());
+        auto child_data =
+            FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+        idx_t length = 0;
+        H3Index cell;
+        while (reader.Next(cell)) {
+          child_data[offset + length++] = cell;
+        }
+        ListVector::SetListSize(result, offset + length);
+        return list_entry_t(offset, length);
+      });
+}
+
+static void SetSizeFunction(DataChunk &args, ExpressionState &state,
+                            Vector &result) {
+  UnaryExecutor::Execute<string_t, uint64_t>(
+      args.data[0], result, args.size(),
+      [&](string_t blob) { return H3SetReader(blob).Size(); });
+}
+
+// Only the run of the cell's resolution is decoded, and only up to the cell
+template <typename T>
+static void SetContainsFunction(DataChunk &args, ExpressionState &state,
+                                Vector &result) {
+  BinaryExecutor::Execute<string_t, T, bool>(
+      args.data[0], args.data[1], result, args.size(),
+      [&](string_t blob, T input) {
+        H3Index cell = input;
+        H3SetReader reader(blob);
+        if (!isValidCell(cell) || !reader.SeekResolution(getResolution(cell))) {
+          return false;
+        }
+        H3Index member;
+        do {
+          if (!reader.Next(member)) {
+            return false;
+          }
+        } while (member < cell);
+        return member == cell;
+      });
+}
+
+// A sorted merge of two sets, writing the cells that only the left set has,
+// that only the right set has, and that both have, as set by the operation
+struct SetIntersectionOperator {
+  static constexpr bool LEFT_ONLY = false;
+  static constexpr bool RIGHT_ONLY = false;
+  static constexpr bool BOTH = true;
+};
+
+struct SetUnionOperator {
+  static constexpr bool LEFT_ONLY = true;
+  static constexpr bool RIGHT_ONLY = true;
+  static constexpr bool BOTH = true;
+};
+
+struct SetDifferenceOperator {
+  static constexpr bool LEFT_ONLY = true;
+  static constexpr bool RIGHT_ONLY = false;
+  static constexpr bool BOTH = false;
+};
+
+template <class OP>
+static void MergeSets(H3SetReader &left, H3SetReader &right,
+                      H3SetWriter &writer) {
+  H3Index leftCell, rightCell;
+  bool hasLeft = left.Next(leftCell);
+  bool hasRight = right.Next(rightCell);
+  while ((hasLeft || OP::RIGHT_ONLY) && (hasRight || OP::LEFT_ONLY) &&
+         (hasLeft || hasRight)) {
+    if (hasLeft && (!hasRight || leftCell < rightCell)) {
+      if (OP::LEFT_ONLY) {
+        writer.Add(leftCell);
+      }
+      hasLeft = left.Next(leftCell);
+    } else if (hasRight && (!hasLeft || rightCell < leftCell)) {
+      if (OP::RIGHT_ONLY) {
+        writer.Add(rightCell);
+      }
+      hasRight = right.Next(rightCell);
+    } else {
+      if (OP::BOTH) {
+        writer.Add(leftCell);
+      }
+      hasLeft = left.Next(leftCell);
+      hasRight = right.Next(rightCell);
+    }
+  }
+}
+
+template <class OP>
+static void SetOperationFunction(DataChunk &args, ExpressionState &state,
+                                 Vector &result) {
+  H3SetWriter writer;
+  BinaryExecutor::Execute<string_t, string_t, string_t>(
+      args.data[0], args.data[1], result, args.size(),
+      [&](string_t leftBlob, string_t rightBlob) {
+        H3SetReader left(leftBlob);
+        H3SetReader right(rightBlob);
+        writer.Reset();
+        MergeSets<OP>(left, right, writer);
+        return writer.Finish(result);
+      });
+}
+
+// Aggregate state for h3_set_agg. Cells are deduplicated whenever the buffer
+// doubles, so repeated cells do not grow it.
+struct SetAggState {
+  vector<H3Index> *cells;
+  idx_t dedupSize;
+  // An invalid cell was added, which makes the set NULL
+  bool invalid;
+};
+
+struct SetAggOperation {
+  static constexpr idx_t MIN_DEDUP_SIZE = 1024;
+
+  template <class STATE> static void Initialize(STATE &state) {
+    state.cells = nullptr;
+    state.dedupSize = MIN_DEDUP_SIZE;
+    state.invalid = false;
+  }
+
+  template <class STATE>
+  static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+    delete state.cells;
+    state.cells = nullptr;
+  }
+
+  static bool IgnoreNull() { return true; }
+
+  template <class STATE> static void SetInvalid(STATE &state) {
+    state.invalid = true;
+    delete state.cells;
+    state.cells = nullptr;
+  }
+
+  template <class STATE> static void Add(STATE &state, H3Index cell) {
+    if (state.invalid) {
+      return;
+    }
+    if (!state.cells) {
+      state.cells = new vector<H3Index>();
+    }
+    state.cells->push_back(cell);
+    if (state.cells->size() >= state.dedupSize) {
+      auto &cells = *state.cells;
+      std::sort(cells.begin(), cells.end());
+      cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+      state.dedupSize = MaxValue(MIN_DEDUP_SIZE, cells.size() * 2);
+    }
+  }
+
+  template <class INPUT_TYPE, class STATE, class OP>
+  static void Operation(STATE &state, const INPUT_TYPE &input,
+                        AggregateUnaryInput &unary_input) {
+    if (isValidCell(input)) {
+      Add(state, input);
+    } else {
+      SetInvalid(state);
+    }
+  }
+
+  template <class INPUT_TYPE, class STATE, class OP>
+  static void ConstantOperation(STATE &state, const INPUT_TYPE &input,
+                                AggregateUnaryInput &unary_input,
+                                idx_t count) {
+    Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+  }
+
+  template <class STATE, class OP>
+  static void Combine(const STATE &source, STATE &target,
+                      AggregateInputData &aggr_input_data) {
+    if (source.invalid) {
+      SetInvalid(target);
+      return;
+    }
+    if (!source.cells || target.invalid) {
+      return;
+    }
+    if (!target.cells) {
+      target.cells = new vector<H3Index>();
+    }
+    for (auto cell : *source.cells) {
+      Add(target, cell);
+    }
+  }
+};
+
+static void SetAggFinalize(Vector &state_vector,
+                           AggregateInputData &aggr_input_data, Vector &result,
+                           idx_t count, idx_t offset) {
+  UnifiedVectorFormat state_data;
+  state_vector.ToUnifiedFormat(count, state_data);
+  auto states = UnifiedVectorFormat::GetData<SetAggState *>(state_data);
+
+  auto &result_validity = FlatVector::Validity(result);
+  auto result_data = FlatVector::GetData<string_t>(result);
+
+  H3SetWriter writer;
+  for (idx_t i = 0; i < count; i++) {
+    auto &state = *states[state_data.sel->get_index(i)];
+    auto rid = i + offset;
+    if (state.invalid || !state.cells) {
+      result_validity.SetInvalid(rid);
+      continue;
+    }
+    result_data[rid] = CellsToSet(*state.cells, writer, result);
+  }
+}
+
+template <typename T>
+static AggregateFunction GetSetAggregate(const LogicalType &type) {
+  return AggregateFunction(
+      {type}, H3SetType(), AggregateFunction::StateSize<SetAggState>,
+      AggregateFunction::StateInitialize<SetAggState, SetAggOperation>,
+      AggregateFunction::UnaryScatterUpdate<SetAggState, T, SetAggOperation>,
+      AggregateFunction::StateCombine<SetAggState, SetAggOperation>,
+      SetAggFinalize,
+      AggregateFunction::UnaryUpdate<SetAggState, T, SetAggOperation>, nullptr,
+      AggregateFunction::StateDestroy<SetAggState, SetAggOperation>);
+}
+
+CreateScalarFunctionInfo H3Functions::GetCellsToSetFunction() {
+  ScalarFunctionSet funcs("h3_cells_to_set");
+  funcs.AddFunction(ScalarFunction({LogicalType::LIST(LogicalType::UBIGINT)},
+                                   H3SetType(), CellsToSetFunction));
+  funcs.AddFunction(ScalarFunction({LogicalType::LIST(LogicalType::BIGINT)},
+                                   H3SetType(), CellsToSetFunction));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSetToCellsFunction() {
+  ScalarFunctionSet funcs("h3_set_to_cells");
+  funcs.AddFunction(ScalarFunction({H3SetType()},
+                                   LogicalType::LIST(LogicalType::UBIGINT),
+                                   SetToCellsFunction));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSetSizeFunction() {
+  ScalarFunctionSet funcs("h3_set_size");
+  funcs.AddFunction(
+      ScalarFunction({H3SetType()}, LogicalType::UBIGINT, SetSizeFunction));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSetContainsFunction() {
+  ScalarFunctionSet funcs("h3_set_contains");
+  funcs.AddFunction(ScalarFunction({H3SetType(), LogicalType::UBIGINT},
+                                   LogicalType::BOOLEAN,
+                                   SetContainsFunction<uint64_t>));
+  funcs.AddFunction(ScalarFunction({H3SetType(), LogicalType::BIGINT},
+                                   LogicalType::BOOLEAN,
+                                   SetContainsFunction<int64_t>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSetIntersectionFunction() {
+  ScalarFunctionSet funcs("h3_set_intersection");
+  funcs.AddFunction(
+      ScalarFunction({H3SetType(), H3SetType()}, H3SetType(),
+                     SetOperationFunction<SetIntersectionOperator>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSetUnionFunction() {
+  ScalarFunctionSet funcs("h3_set_union");
+  funcs.AddFunction(ScalarFunction({H3SetType(), H3SetType()}, H3SetType(),
+                                   SetOperationFunction<SetUnionOperator>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+CreateScalarFunctionInfo H3Functions::GetSetDifferenceFunction() {
+  ScalarFunctionSet funcs("h3_set_difference");
+  funcs.AddFunction(
+      ScalarFunction({H3SetType(), H3SetType()}, H3SetType(),
+                     SetOperationFunction<SetDifferenceOperator>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
+AggregateFunctionSet H3Functions::GetSetAggFunction() {
+  AggregateFunctionSet funcs("h3_set_agg");
+  funcs.AddFunction(GetSetAggregate<uint64_t>(LogicalType::UBIGINT));
+  funcs.AddFunction(GetSetAggregate<int64_t>(LogicalType::BIGINT));
+  return funcs;
+}
+
+} // namespace duckdb
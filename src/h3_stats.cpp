@@ -0,0 +1,395 @@
+#include "h3_stats.hpp"
+#include "h3_common.hpp"
+#include "h3_functions.hpp"
+
+namespace duckdb {
+
+thread_local bool H3Stats::collecting = false;
+thread_local idx_t H3Stats::materializeNanos = 0;
+
+struct H3FunctionCounters {
+  static constexpr idx_t MAX_PATHS = 4;
+
+  // Chunks
+  atomic<idx_t> calls{0};
+  atomic<idx_t> rows{0};
+  // Time in the kernel, and the part of it spent writing results
+  atomic<idx_t> nanos{0};
+  atomic<idx_t> materializeNanos{0};
+  // NULL results, and NULL results for rows without a NULL input (H3 errors)
+  atomic<idx_t> nullRows{0};
+  atomic<idx_t> errorRows{0};
+  // Rows computed by each algorithm of the function, see CountPaths
+  atomic<const char *const *> pathNames{nullptr};
+  atomic<idx_t> pathCount{0};
+  atomic<idx_t> paths[MAX_PATHS] = {};
+};
+
+// Counters of one thread. Each is only written by its thread, and read (or
+// reset) by h3_stats() and h3_stats_reset().
+struct H3ThreadCounters {
+  static constexpr idx_t MAX_FUNCTIONS = 256;
+  H3FunctionCounters functions[MAX_FUNCTIONS];
+};
+
+class H3StatsRegistry {
+public:
+  static H3StatsRegistry &Get() {
+    static H3StatsRegistry registry;
+    return registry;
+  }
+
+  // Functions are registered again by each database that loads the
+  // extension, and keep their first ID.
+  idx_t Register(const string &name) {
+    lock_guard<mutex> guard(lock);
+    auto entry = ids.find(name);
+    if (entry != ids.end()) {
+      return entry->second;
+    }
+    idx_t id = names.size();
+    names.push_back(name);
+    ids[name] = id;
+    return id;
+  }
+
+  idx_t Lookup(const string &name) {
+    lock_guard<mutex> guard(lock);
+    auto entry = ids.find(name);
+    return entry == ids.end() ? DConstants::INVALID_INDEX : entry->second;
+  }
+
+  H3FunctionCounters &Counters(idx_t id) {
+    thread_local shared_ptr<H3ThreadCounters> local;
+    if (!local) {
+      local = make_shared_ptr<H3ThreadCounters>();
+      lock_guard<mutex> guard(lock);
+      threads.push_back(local);
+    }
+    return local->functions[id];
+  }
+
+  struct Totals {
+    string name;
+    idx_t calls = 0;
+    idx_t rows = 0;
+    idx_t nanos = 0;
+    idx_t materializeNanos = 0;
+    idx_t nullRows = 0;
+    idx_t errorRows = 0;
+    vector<Value> pathNames;
+    vector<Value> paths;
+  };
+
+  vector<Totals> Collect() {
+    lock_guard<mutex> guard(lock);
+    vector<Totals> result;
+    for (idx_t id = 0; id < names.size(); id++) {
+      Totals totals;
+      totals.name = names[id];
+      const char *const *pathNames = nullptr;
+      idx_t pathCount = 0;
+      idx_t paths[H3FunctionCounters::MAX_PATHS] = {};
+      for (auto &thread : threads) {
+        auto &counters = thread->functions[id];
+        totals.calls += counters.calls;
+        totals.rows += counters.rows;
+        totals.nanos += counters.nanos;
+        totals.materializeNanos += counters.materializeNanos;
+        totals.nullRows += counters.nullRows;
+        totals.errorRows += counters.errorRows;
+        if (counters.pathNames) {
+          pathNames = counters.pathNames;
+          pathCount = counters.pathCount;
+        }
+        for (idx_t i = 0; i < H3FunctionCounters::MAX_PATHS; i++) {
+          paths[i] += counters.paths[i];
+        }
+      }
+      for (idx_t i = 0; pathNames && i < pathCount; i++) {
+        totals.pathNames.emplace_back(pathNames[i]);
+        totals.paths.push_back(Value::UBIGINT(paths[i]));
+      }
+      if (totals.calls > 0) {
+        result.push_back(std::move(totals));
+      }
+    }
+    return result;
+  }
+
+  void Reset() {
+    lock_guard<mutex> guard(lock);
+    for (auto &thread : threads) {
+      for (auto &counters : thread->functions) {
+        counters.calls = 0;
+        counters.rows = 0;
+        counters.nanos = 0;
+        counters.materializeNanos = 0;
+        counters.nullRows = 0;
+        counters.errorRows = 0;
+        for (auto &path : counters.paths) {
+          path = 0;
+        }
+      }
+    }
+  }
+
+private:
+  mutex lock;
+  vector<string> names;
+  unordered_map<string, idx_t> ids;
+  vector<shared_ptr<H3ThreadCounters>> threads;
+};
+
+// Counts the NULL results of a chunk, and those of them with no NULL input
+static void CountNullRows(DataChunk &args, Vector &result, idx_t &nullRows,
+                          idx_t &errorRows) {
+  auto count = args.size();
+  UnifiedVectorFormat result_data;
+  result.ToUnifiedFormat(count, result_data);
+  if (result_data.validity.AllValid()) {
+    return;
+  }
+  vector<UnifiedVectorFormat> inputs(args.ColumnCount());
+  for (idx_t c = 0; c < args.ColumnCount(); c++) {
+    args.data[c].ToUnifiedFormat(count, inputs[c]);
+  }
+  for (idx_t i = 0; i < count; i++) {
+    if (result_data.validity.RowIsValid(result_data.sel->get_index(i))) {
+      continue;
+    }
+    nullRows++;
+    bool nullInput = false;
+    for (auto &input : inputs) {
+      nullInput =
+          nullInput || !input.validity.RowIsValid(input.sel->get_index(i));
+    }
+    if (!nullInput) {
+      errorRows++;
+    }
+  }
+}
+
+// h3_stats_enabled is a per connection setting, read when a query binds a
+// function
+static bool StatsEnabled(ClientContext &context) {
+  Value enabled;
+  if (!context.TryGetCurrentSetting("h3_stats_enabled", enabled)) {
+    return false;
+  }
+  return !enabled.IsNull() && BooleanValue::Get(enabled);
+}
+
+// Counters of the instrumented kernel running on this thread
+static thread_local H3FunctionCounters *currentCounters = nullptr;
+
+// Marks the thread as collecting for a kernel, until it returns or throws
+class CollectingGuard {
+public:
+  explicit CollectingGuard(H3FunctionCounters &counters) {
+    H3Stats::collecting = true;
+    H3Stats::materializeNanos = 0;
+    currentCounters = &counters;
+  }
+
+  ~CollectingGuard() {
+    H3Stats::collecting = false;
+    currentCounters = nullptr;
+  }
+};
+
+static scalar_function_t InstrumentKernel(idx_t id, scalar_function_t kernel) {
+  return [id, kernel](DataChunk &args, ExpressionState &state,
+                      Vector &result) {
+    auto &counters = H3StatsRegistry::Get().Counters(id);
+    idx_t materializeNanos;
+    auto start = std::chrono::steady_clock::now();
+    {
+      CollectingGuard guard(counters);
+      kernel(args, state, result);
+      materializeNanos = H3Stats::materializeNanos;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    idx_t nullRows = 0, errorRows = 0;
+    CountNullRows(args, result, nullRows, errorRows);
+
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.rows.fetch_add(args.size(), std::memory_order_relaxed);
+    counters.nanos.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+    counters.materializeNanos.fetch_add(materializeNanos,
+                                        std::memory_order_relaxed);
+    counters.nullRows.fetch_add(nullRows, std::memory_order_relaxed);
+    counters.errorRows.fetch_add(errorRows, std::memory_order_relaxed);
+  };
+}
+
+// Carries the function's ID and its own bind to InstrumentedBind
+struct H3StatsFunctionInfo : public ScalarFunctionInfo {
+  H3StatsFunctionInfo(idx_t id_p, bind_scalar_function_t bind_p)
+      : id(id_p), bind(bind_p) {}
+
+  idx_t id;
+  bind_scalar_function_t bind;
+};
+
+// Runs the function's own bind, which may choose the kernel, and then
+// instruments that kernel if the query's connection collects stats. The
+// setting is thus read once per query, and a query bound with collection off
+// pays nothing for it.
+static unique_ptr<FunctionData>
+InstrumentedBind(ClientContext &context, ScalarFunction &bound_function,
+                 vector<unique_ptr<Expression>> &arguments) {
+  auto &info = bound_function.function_info->Cast<H3StatsFunctionInfo>();
+  unique_ptr<FunctionData> bind_data;
+  if (info.bind) {
+    bind_data = info.bind(context, bound_function, arguments);
+  }
+  if (StatsEnabled(context)) {
+    bound_function.function =
+        InstrumentKernel(info.id, std::move(bound_function.function));
+  }
+  return bind_data;
+}
+
+void H3Stats::Instrument(CreateScalarFunctionInfo &info) {
+  auto id = H3StatsRegistry::Get().Register(info.name);
+  if (id >= H3ThreadCounters::MAX_FUNCTIONS) {
+    return;
+  }
+  for (auto &function : info.functions.functions) {
+    if (function.function_info) {
+      continue;
+    }
+    function.function_info =
+        make_shared_ptr<H3StatsFunctionInfo>(id, function.bind);
+    function.bind = InstrumentedBind;
+  }
+}
+
+void H3Stats::CountPaths(const char *const *names, const idx_t *counts,
+                         idx_t n) {
+  if (!collecting) {
+    return;
+  }
+  auto &counters = *currentCounters;
+  n = MinValue(n, H3FunctionCounters::MAX_PATHS);
+  if (!counters.pathNames) {
+    counters.pathCount = n;
+    counters.pathNames = names;
+  }
+  for (idx_t i = 0; i < n; i++) {
+    counters.paths[i].fetch_add(counts[i], std::memory_order_relaxed);
+  }
+}
+
+struct H3StatsGlobalState : public GlobalTableFunctionState {
+  vector<H3StatsRegistry::Totals> totals;
+  idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData>
+H3StatsBind(ClientContext &context, TableFunctionBindInput &input,
+            vector<LogicalType> &return_types, vector<string> &names) {
+  names.emplace_back("function");
+  return_types.emplace_back(LogicalType::VARCHAR);
+  names.emplace_back("calls");
+  return_types.emplace_back(LogicalType::UBIGINT);
+  names.emplace_back("rows");
+  return_types.emplace_back(LogicalType::UBIGINT);
+  names.emplace_back("null_rows");
+  return_types.emplace_back(LogicalType::UBIGINT);
+  names.emplace_back("error_rows");
+  return_types.emplace_back(LogicalType::UBIGINT);
+  names.emplace_back("time_ms");
+  return_types.emplace_back(LogicalType::DOUBLE);
+  names.emplace_back("core_ms");
+  return_types.emplace_back(LogicalType::DOUBLE);
+  names.emplace_back("materialize_ms");
+  return_types.emplace_back(LogicalType::DOUBLE);
+  names.emplace_back("paths");
+  return_types.emplace_back(
+      LogicalType::MAP(LogicalType::VARCHAR, LogicalType::UBIGINT));
+  return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState>
+H3StatsInit(ClientContext &context, TableFunctionInitInput &input) {
+  auto result = make_uniq<H3StatsGlobalState>();
+  result->totals = H3StatsRegistry::Get().Collect();
+  return std::move(result);
+}
+
+// Counters of each function that ran since they were last reset
+static void H3StatsFunction(ClientContext &context, TableFunctionInput &data_p,
+                            DataChunk &output) {
+  auto &gstate = data_p.global_state->Cast<H3StatsGlobalState>();
+  idx_t count = 0;
+  while (gstate.offset < gstate.totals.size() && count < STANDARD_VECTOR_SIZE) {
+    auto &totals = gstate.totals[gstate.offset++];
+    output.SetValue(0, count, Value(totals.name));
+    output.SetValue(1, count, Value::UBIGINT(totals.calls));
+    output.SetValue(2, count, Value::UBIGINT(totals.rows));
+    output.SetValue(3, count, Value::UBIGINT(totals.nullRows));
+    output.SetValue(4, count, Value::UBIGINT(totals.errorRows));
+    auto materializeNanos = MinValue(totals.materializeNanos, totals.nanos);
+    output.SetValue(5, count, Value::DOUBLE(totals.nanos / 1e6));
+    output.SetValue(6, count,
+                    Value::DOUBLE((totals.nanos - materializeNanos) / 1e6));
+    output.SetValue(7, count, Value::DOUBLE(materializeNanos / 1e6));
+    output.SetValue(8, count,
+                    Value::MAP(LogicalType::VARCHAR, LogicalType::UBIGINT,
+                               std::move(totals.pathNames),
+                               std::move(totals.paths)));
+    count++;
+  }
+  output.SetCardinality(count);
+}
+
+struct H3StatsResetGlobalState : public GlobalTableFunctionState {
+  bool done = false;
+};
+
+static unique_ptr<FunctionData>
+H3StatsResetBind(ClientContext &context, TableFunctionBindInput &input,
+                 vector<LogicalType> &return_types, vector<string> &names) {
+  names.emplace_back("success");
+  return_types.emplace_back(LogicalType::BOOLEAN);
+  return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState>
+H3StatsResetInit(ClientContext &context, TableFunctionInitInput &input) {
+  return make_uniq<H3StatsResetGlobalState>();
+}
+
+static void H3StatsResetFunction(ClientContext &context,
+                                 TableFunctionInput &data_p,
+                                 DataChunk &output) {
+  auto &gstate = data_p.global_state->Cast<H3StatsResetGlobalState>();
+  if (gstate.done) {
+    return;
+  }
+  H3StatsRegistry::Get().Reset();
+  output.SetValue(0, 0, Value::BOOLEAN(true));
+  output.SetCardinality(1);
+  gstate.done = true;
+}
+
+TableFunctionSet H3Functions::GetStatsFunction() {
+  TableFunctionSet funcs("h3_stats");
+  funcs.AddFunction(
+      TableFunction({}, H3StatsFunction, H3StatsBind, H3StatsInit));
+  return funcs;
+}
+
+TableFunctionSet H3Functions::GetStatsResetFunction() {
+  TableFunctionSet funcs("h3_stats_reset");
+  funcs.AddFunction(TableFunction({}, H3StatsResetFunction, H3StatsResetBind,
+                                  H3StatsResetInit));
+  return funcs;
+}
+
+} // namespace duckdb
@@ -1,13 +1,10 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
 
-namespace duckdb {
+#include <bitset>
 
-struct GridDiskOperator {
-  static H3Error fn(H3Index origin, int32_t k, H3Index *out) {
-    return gridDisk(origin, k, out);
-  }
-};
+namespace duckdb {
 
 struct GridDiskUnsafeOperator {
   static H3Error fn(H3Index origin, int32_t k, H3Index *out) {
@@ -38,6 +35,7 @@ static void GridDiskTmplFunction(DataChunk &args, ExpressionState &state,
       if (err2) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (auto val : out) {
           if (val != H3_NULL) {
@@ -85,6 +83,7 @@ static void GridDiskTmplVarcharFunction(DataChunk &args, ExpressionState &state,
         if (err2) {
           result.SetValue(i, Value(LogicalType::SQLNULL));
         } else {
+          H3StatsMaterialize materialize;
           int64_t actual = 0;
           for (auto val : out) {
             if (val != H3_NULL) {
@@ -105,6 +104,236 @@ static void GridDiskTmplVarcharFunction(DataChunk &args, ExpressionState &state,
   result.Verify(args.size());
 }
 
+// For each base cell, the pentagon base cells among it and its neighbors.
+// A grid disk that does not span more than one base cell can only reach a
+// pentagon through one of these. `near` marks the base cells with any.
+struct PentagonNeighborTable {
+  std::bitset<NUM_BASE_CELLS> near;
+  vector<H3Index> pentagons[NUM_BASE_CELLS];
+  // 7^res, the number of cells a hexagon base cell has at res
+  int64_t cellsPerBaseCell[MAX_H3_RES + 1];
+};
+
+static const PentagonNeighborTable &PentagonNeighbors() {
+  static const PentagonNeighborTable table = [] {
+    PentagonNeighborTable result;
+    H3Index baseCells[NUM_BASE_CELLS];
+    getRes0Cells(baseCells);
+    for (auto baseCell : baseCells) {
+      H3Index disk[7] = {};
+      if (gridDisk(baseCell, 1, disk)) {
+        continue;
+      }
+      auto number = getBaseCellNumber(baseCell);
+      for (auto neighbor : disk) {
+        if (neighbor != H3_NULL && isPentagon(neighbor)) {
+          result.near.set(number);
+          result.pentagons[number].push_back(neighbor);
+        }
+      }
+    }
+    result.cellsPerBaseCell[0] = 1;
+    for (int res = 1; res <= MAX_H3_RES; res++) {
+      result.cellsPerBaseCell[res] = result.cellsPerBaseCell[res - 1] * 7;
+    }
+    return result;
+  }();
+  return table;
+}
+
+// Algorithms h3_grid_disk computes a row with, counted in h3_stats()
+enum class GridDiskPath : uint8_t { UNSAFE = 0, SAFE = 1, FALLBACK = 2 };
+static constexpr idx_t GRID_DISK_PATH_COUNT = 3;
+static const char *const GRID_DISK_PATH_NAMES[GRID_DISK_PATH_COUNT] = {
+    "unsafe", "safe", "fallback"};
+
+// gridDisk runs gridDiskUnsafe and, when that fails on a pentagon, starts
+// over with the safe algorithm. When a pentagon is known to be within k of
+// the origin, the unsafe attempt is skipped. The exact check costs two local
+// IJ projections per pentagon, so it only runs for origins in a base cell
+// near a pentagon, and only when the disk covers a sizable share of a base
+// cell. Smaller disks rarely reach a pentagon, and the occasional fallback
+// is cheaper than checking every row.
+class AdaptiveGridDisk {
+public:
+  H3Error Run(H3Index origin, int32_t k, int64_t size, H3Index *out) {
+    if (ReachesPentagon(origin, k, size)) {
+      counts[static_cast<idx_t>(GridDiskPath::SAFE)]++;
+      return Safe(origin, k, size, out);
+    }
+    H3Error err = gridDiskUnsafe(origin, k, out);
+    if (!err) {
+      counts[static_cast<idx_t>(GridDiskPath::UNSAFE)]++;
+      return err;
+    }
+    counts[static_cast<idx_t>(GridDiskPath::FALLBACK)]++;
+    return Safe(origin, k, size, out);
+  }
+
+  // Reports the paths taken to h3_stats()
+  void Flush() {
+    H3Stats::CountPaths(GRID_DISK_PATH_NAMES, counts, GRID_DISK_PATH_COUNT);
+    for (auto &count : counts) {
+      count = 0;
+    }
+  }
+
+private:
+  // A disk covering less than 1 / PENTAGON_CHECK_SHARE of a base cell skips
+  // the exact pentagon check
+  static constexpr int64_t PENTAGON_CHECK_SHARE = 64;
+
+  static bool ReachesPentagon(H3Index origin, int32_t k, int64_t size) {
+    auto &table = PentagonNeighbors();
+    int baseCell = getBaseCellNumber(origin);
+    if (baseCell < 0 || baseCell >= NUM_BASE_CELLS ||
+        !table.near.test(baseCell)) {
+      return false;
+    }
+    if (isPentagon(origin)) {
+      return true;
+    }
+    int res = getResolution(origin);
+    if (size * PENTAGON_CHECK_SHARE < table.cellsPerBaseCell[res]) {
+      return false;
+    }
+    for (auto pentagon : table.pentagons[baseCell]) {
+      H3Index center;
+      int64_t distance;
+      if (!cellToCenterChild(pentagon, res, &center) &&
+          !gridDistance(origin, center, &distance) && distance <= k) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  H3Error Safe(H3Index origin, int32_t k, int64_t size, H3Index *out) {
+    // The safe algorithm uses the output as a hash set
+    std::fill(out, out + size, H3_NULL);
+    distances.resize(size);
+    return gridDiskDistancesSafe(origin, k, out, distances.data());
+  }
+
+  vector<int32_t> distances;
+  idx_t counts[GRID_DISK_PATH_COUNT] = {};
+};
+
+struct GridDiskLocalState : public FunctionLocalState {
+  static unique_ptr<FunctionLocalState>
+  Init(ExpressionState &state, const BoundFunctionExpression &expr,
+       FunctionData *bind_data) {
+    return make_uniq<GridDiskLocalState>();
+  }
+
+  AdaptiveGridDisk gridDisk;
+};
+
+template <typename T>
+static void GridDiskFunction(DataChunk &args, ExpressionState &state,
+                             Vector &result) {
+  auto &lstate = ExecuteFunctionState::GetFunctionState(state)
+                     ->Cast<GridDiskLocalState>();
+  auto count = args.size();
+  UnifiedVectorFormat origin_data;
+  args.data[0].ToUnifiedFormat(count, origin_data);
+  auto origins = UnifiedVectorFormat::GetData<T>(origin_data);
+  UnifiedVectorFormat k_data;
+  args.data[1].ToUnifiedFormat(count, k_data);
+  auto ks = UnifiedVectorFormat::GetData<int32_t>(k_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_entries = FlatVector::GetData<list_entry_t>(result);
+  auto &result_validity = FlatVector::Validity(result);
+
+  idx_t offset = ListVector::GetListSize(result);
+  for (idx_t i = 0; i < count; i++) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 0;
+
+    auto origin_index = origin_data.sel->get_index(i);
+    auto k_index = k_data.sel->get_index(i);
+    int64_t sz;
+    if (!origin_data.validity.RowIsValid(origin_index) ||
+        !k_data.validity.RowIsValid(k_index) ||
+        maxGridDiskSize(ks[k_index], &sz)) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+
+    ListVector::Reserve(result, offset + sz);
+    auto cells = reinterpret_cast<H3Index *>(
+        FlatVector::GetData<T>(ListVector::GetEntry(result)) + offset);
+    if (lstate.gridDisk.Run(origins[origin_index], ks[k_index], sz, cells)) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+    // Pentagons leave some of the output empty
+    H3StatsMaterialize materialize;
+    idx_t actual = 0;
+    for (int64_t j = 0; j < sz; j++) {
+      if (cells[j] != H3_NULL) {
+        cells[actual++] = cells[j];
+      }
+    }
+    result_entries[i].length = actual;
+    offset += actual;
+  }
+  ListVector::SetListSize(result, offset);
+  lstate.gridDisk.Flush();
+
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(count);
+}
+
+static void GridDiskVarcharFunction(DataChunk &args, ExpressionState &state,
+                                    Vector &result) {
+  auto &lstate = ExecuteFunctionState::GetFunctionState(state)
+                     ->Cast<GridDiskLocalState>();
+  auto result_data = FlatVector::GetData<list_entry_t>(result);
+  vector<H3Index> out;
+  for (idx_t i = 0; i < args.size(); i++) {
+    result_data[i].offset = ListVector::GetListSize(result);
+
+    string originInput = args.GetValue(0, i)
+                             .DefaultCastAs(LogicalType::VARCHAR)
+                             .GetValue<string>();
+    int32_t k = args.GetValue(1, i)
+                    .DefaultCastAs(LogicalType::INTEGER)
+                    .GetValue<int32_t>();
+
+    uint64_t origin;
+    int64_t sz;
+    if (stringToH3(originInput.c_str(), &origin) || maxGridDiskSize(k, &sz)) {
+      result.SetValue(i, Value(LogicalType::SQLNULL));
+      continue;
+    }
+    out.resize(sz);
+    if (lstate.gridDisk.Run(origin, k, sz, out.data())) {
+      result.SetValue(i, Value(LogicalType::SQLNULL));
+      continue;
+    }
+    H3StatsMaterialize materialize;
+    int64_t actual = 0;
+    for (auto val : out) {
+      if (val != H3_NULL) {
+        auto str = StringUtil::Format("%llx", val);
+        ListVector::PushBack(result, str);
+        actual++;
+      }
+    }
+    result_data[i].length = actual;
+  }
+  lstate.gridDisk.Flush();
+
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(args.size());
+}
+
 struct GridDiskDistancesOperator {
   static H3Error fn(H3Index origin, int32_t k, H3Index *out,
                     int32_t *distancesOut) {
@@ -160,6 +389,7 @@ static void GridDiskDistancesTmplFunction(DataChunk &args,
           }
         }
 
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (auto val : results) {
           ListVector::PushBack(result, Value::LIST(LogicalType::UBIGINT, val));
@@ -217,6 +447,7 @@ static void GridDiskDistancesTmplVarcharFunction(DataChunk &args,
             }
           }
 
+          H3StatsMaterialize materialize;
           int64_t actual = 0;
           for (auto val : results) {
             ListVector::PushBack(result,
@@ -257,6 +488,7 @@ static void GridRingFunction(DataChunk &args, ExpressionState &state,
       if (err2) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (auto val : out) {
           if (val != H3_NULL) {
@@ -302,6 +534,7 @@ static void GridRingVarcharFunction(DataChunk &args, ExpressionState &state,
         if (err2) {
           result.SetValue(i, Value(LogicalType::SQLNULL));
         } else {
+          H3StatsMaterialize materialize;
           int64_t actual = 0;
           for (auto val : out) {
             if (val != H3_NULL) {
@@ -340,6 +573,7 @@ static void GridRingUnsafeFunction(DataChunk &args, ExpressionState &state,
     if (err) {
       result.SetValue(i, Value(LogicalType::SQLNULL));
     } else {
+      H3StatsMaterialize materialize;
       int64_t actual = 0;
       for (auto val : out) {
         if (val != H3_NULL) {
@@ -381,6 +615,7 @@ static void GridRingUnsafeVarcharFunction(DataChunk &args,
       if (err1) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         int64_t actual = 0;
         for (auto val : out) {
           if (val != H3_NULL) {
@@ -400,45 +635,80 @@ static void GridRingUnsafeVarcharFunction(DataChunk &args,
   result.Verify(args.size());
 }
 
+// Extends cells, which must end in the origin of the path, with the grid path
+// to destination. The origin is shared rather than repeated. On error, cells
+// is left as it was.
+static H3Error AppendGridPathCells(vector<H3Index> &cells,
+                                   H3Index destination) {
+  H3Index origin = cells.back();
+  idx_t offset = cells.size() - 1;
+  int64_t sz;
+  H3Error err = gridPathCellsSize(origin, destination, &sz);
+  if (err) {
+    return err;
+  }
+  cells.resize(offset + sz);
+  err = gridPathCells(origin, destination, &cells[offset]);
+  if (err) {
+    cells.resize(offset);
+    cells.push_back(origin);
+  }
+  return err;
+}
+
+template <typename T>
 static void GridPathCellsFunction(DataChunk &args, ExpressionState &state,
                                   Vector &result) {
-  auto result_data = FlatVector::GetData<list_entry_t>(result);
-  for (idx_t i = 0; i < args.size(); i++) {
-    result_data[i].offset = ListVector::GetListSize(result);
-
-    uint64_t origin = args.GetValue(0, i)
-                          .DefaultCastAs(LogicalType::UBIGINT)
-                          .GetValue<uint64_t>();
-    uint64_t destination = args.GetValue(1, i)
-                               .DefaultCastAs(LogicalType::UBIGINT)
-                               .GetValue<uint64_t>();
+  auto count = args.size();
+  UnifiedVectorFormat origin_data;
+  args.data[0].ToUnifiedFormat(count, origin_data);
+  auto origins = UnifiedVectorFormat::GetData<T>(origin_data);
+  UnifiedVectorFormat destination_data;
+  args.data[1].ToUnifiedFormat(count, destination_data);
+  auto destinations = UnifiedVectorFormat::GetData<T>(destination_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_entries = FlatVector::GetData<list_entry_t>(result);
+  auto &result_validity = FlatVector::Validity(result);
+
+  idx_t offset = ListVector::GetListSize(result);
+  for (idx_t i = 0; i < count; i++) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 0;
+
+    auto origin_index = origin_data.sel->get_index(i);
+    auto destination_index = destination_data.sel->get_index(i);
+    if (!origin_data.validity.RowIsValid(origin_index) ||
+        !destination_data.validity.RowIsValid(destination_index)) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+    H3Index origin = origins[origin_index];
+    H3Index destination = destinations[destination_index];
 
     int64_t sz;
-    H3Error err1 = gridPathCellsSize(origin, destination, &sz);
-    if (err1) {
-      result.SetValue(i, Value(LogicalType::SQLNULL));
-    } else {
-      std::vector<H3Index> out(sz);
-      H3Error err2 = gridPathCells(origin, destination, out.data());
-      if (err2) {
-        result.SetValue(i, Value(LogicalType::SQLNULL));
-      } else {
-        int64_t actual = 0;
-        for (auto val : out) {
-          if (val != H3_NULL) {
-            ListVector::PushBack(result, Value::UBIGINT(val));
-            actual++;
-          }
-        }
-
-        result_data[i].length = actual;
-      }
+    if (gridPathCellsSize(origin, destination, &sz)) {
+      result_validity.SetInvalid(i);
+      continue;
     }
+    // The path is written straight into the list child, rather than through
+    // a temporary vector and a Value per cell.
+    ListVector::Reserve(result, offset + sz);
+    auto cells = FlatVector::GetData<T>(ListVector::GetEntry(result));
+    if (gridPathCells(origin, destination,
+                      reinterpret_cast<H3Index *>(cells + offset))) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+    result_entries[i].length = sz;
+    offset += sz;
   }
+  ListVector::SetListSize(result, offset);
+
   if (args.AllConstant()) {
     result.SetVectorType(VectorType::CONSTANT_VECTOR);
   }
-  result.Verify(args.size());
+  result.Verify(count);
 }
 
 static void GridPathCellsVarcharFunction(DataChunk &args,
@@ -471,6 +741,7 @@ static void GridPathCellsVarcharFunction(DataChunk &args,
         if (err3) {
           result.SetValue(i, Value(LogicalType::SQLNULL));
         } else {
+          H3StatsMaterialize materialize;
           int64_t actual = 0;
           for (auto val : out) {
             if (val != H3_NULL) {
@@ -491,16 +762,298 @@ static void GridPathCellsVarcharFunction(DataChunk &args,
   result.Verify(args.size());
 }
 
+struct GridPathCellsStreamLocalState : public LocalTableFunctionState {
+  // Row of the current input chunk whose path is being emitted
+  idx_t inputRow = 0;
+  bool pathLoaded = false;
+  // Path of that row, and the next of its cells to emit. The buffer is
+  // reused between rows.
+  vector<H3Index> path;
+  idx_t pathOffset = 0;
+};
+
+static unique_ptr<FunctionData>
+GridPathCellsStreamBind(ClientContext &context, TableFunctionBindInput &input,
+                        vector<LogicalType> &return_types,
+                        vector<string> &names) {
+  auto &types = input.input_table_types;
+  if (types.size() != 2 || types[0] != types[1] ||
+      (types[0] != LogicalType::UBIGINT && types[0] != LogicalType::BIGINT)) {
+    throw BinderException("h3_grid_path_cells_stream: input must have two "
+                          "columns (origin, destination) of the same type, "
+                          "UBIGINT or BIGINT");
+  }
+  auto &type = types[0];
+  names.emplace_back("origin");
+  return_types.emplace_back(type);
+  names.emplace_back("destination");
+  return_types.emplace_back(type);
+  names.emplace_back("path_index");
+  return_types.emplace_back(LogicalType::BIGINT);
+  names.emplace_back("cell");
+  return_types.emplace_back(type);
+  return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<LocalTableFunctionState>
+GridPathCellsStreamInitLocal(ExecutionContext &context,
+                             TableFunctionInitInput &input,
+                             GlobalTableFunctionState *global_state) {
+  return make_uniq<GridPathCellsStreamLocalState>();
+}
+
+// Emits the grid path of each input row as one output row per cell. Only
+// the path of the current row is held, and it is emitted over as many output
+// chunks as it needs, so long paths are never materialized as a LIST.
+static OperatorResultType
+GridPathCellsStreamFunction(ExecutionContext &context,
+                            TableFunctionInput &data_p, DataChunk &input,
+                            DataChunk &output) {
+  auto &lstate = data_p.local_state->Cast<GridPathCellsStreamLocalState>();
+
+  // UBIGINT and BIGINT cells share a representation
+  UnifiedVectorFormat origin_data;
+  input.data[0].ToUnifiedFormat(input.size(), origin_data);
+  auto origins = UnifiedVectorFormat::GetData<uint64_t>(origin_data);
+  UnifiedVectorFormat destination_data;
+  input.data[1].ToUnifiedFormat(input.size(), destination_data);
+  auto destinations =
+      UnifiedVectorFormat::GetData<uint64_t>(destination_data);
+
+  auto out_origins = FlatVector::GetData<uint64_t>(output.data[0]);
+  auto out_destinations = FlatVector::GetData<uint64_t>(output.data[1]);
+  auto out_indexes = FlatVector::GetData<int64_t>(output.data[2]);
+  auto out_cells = FlatVector::GetData<uint64_t>(output.data[3]);
+
+  idx_t count = 0;
+  while (count < STANDARD_VECTOR_SIZE) {
+    if (!lstate.pathLoaded) {
+      if (lstate.inputRow >= input.size()) {
+        lstate.inputRow = 0;
+        output.SetCardinality(count);
+        return OperatorResultType::NEED_MORE_INPUT;
+      }
+      auto origin_index = origin_data.sel->get_index(lstate.inputRow);
+      auto destination_index =
+          destination_data.sel->get_index(lstate.inputRow);
+      lstate.path.clear();
+      lstate.pathOffset = 0;
+      lstate.pathLoaded = true;
+      // Rows with a NULL or failing path emit nothing
+      if (origin_data.validity.RowIsValid(origin_index) &&
+          destination_data.validity.RowIsValid(destination_index)) {
+        lstate.path.push_back(origins[origin_index]);
+        if (AppendGridPathCells(lstate.path,
+                                destinations[destination_index])) {
+          lstate.path.clear();
+        }
+      }
+    }
+
+    auto &path = lstate.path;
+    if (!path.empty()) {
+      H3Index origin = path.front();
+      H3Index destination = path.back();
+      while (lstate.pathOffset < path.size() && count < STANDARD_VECTOR_SIZE) {
+        out_origins[count] = origin;
+        out_destinations[count] = destination;
+        out_indexes[count] = lstate.pathOffset;
+        out_cells[count] = path[lstate.pathOffset];
+        lstate.pathOffset++;
+        count++;
+      }
+    }
+    if (lstate.pathOffset >= path.size()) {
+      lstate.pathLoaded = false;
+      lstate.inputRow++;
+    }
+  }
+  output.SetCardinality(count);
+  return OperatorResultType::HAVE_MORE_OUTPUT;
+}
+
+// Stitches a time ordered sequence of cells into a contiguous path, filling
+// the gap between consecutive cells with their grid path. Gaps that have no
+// grid path (e.g. across pentagon distortion, or between resolutions) are
+// left as they are.
+struct TrajectoryCellsState {
+  vector<H3Index> *cells;
+};
+
+static void AppendTrajectoryCell(vector<H3Index> &cells, H3Index cell) {
+  if (cells.empty()) {
+    cells.push_back(cell);
+    return;
+  }
+  if (cells.back() == cell) {
+    return;
+  }
+  if (AppendGridPathCells(cells, cell)) {
+    cells.push_back(cell);
+  }
+}
+
+struct TrajectoryCellsOperation {
+  template <class STATE> static void Initialize(STATE &state) {
+    state.cells = nullptr;
+  }
+
+  template <class STATE>
+  static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+    delete state.cells;
+    state.cells = nullptr;
+  }
+
+  static bool IgnoreNull() { return true; }
+
+  template <class INPUT_TYPE, class STATE, class OP>
+  static void Operation(STATE &state, const INPUT_TYPE &input,
+                        AggregateUnaryInput &unary_input) {
+    if (!isValidCell(input)) {
+      return;
+    }
+    if (!state.cells) {
+      state.cells = new vector<H3Index>();
+    }
+    AppendTrajectoryCell(*state.cells, input);
+  }
+
+  template <class INPUT_TYPE, class STATE, class OP>
+  static void ConstantOperation(STATE &state, const INPUT_TYPE &input,
+                                AggregateUnaryInput &unary_input,
+                                idx_t count) {
+    // Repeats of a cell collapse into one
+    Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+  }
+
+  template <class STATE, class OP>
+  static void Combine(const STATE &source, STATE &target,
+                      AggregateInputData &aggr_input_data) {
+    if (!source.cells) {
+      return;
+    }
+    if (!target.cells) {
+      target.cells = new vector<H3Index>(*source.cells);
+      return;
+    }
+    // The source follows the target, so only the gap between them is filled
+    auto &cells = *target.cells;
+    AppendTrajectoryCell(cells, source.cells->front());
+    cells.insert(cells.end(), source.cells->begin() + 1, source.cells->end());
+  }
+};
+
+template <typename T>
+static void TrajectoryCellsFinalize(Vector &state_vector,
+                                    AggregateInputData &aggr_input_data,
+                                    Vector &result, idx_t count,
+                                    idx_t offset) {
+  UnifiedVectorFormat state_data;
+  state_vector.ToUnifiedFormat(count, state_data);
+  auto states =
+      UnifiedVectorFormat::GetData<TrajectoryCellsState *>(state_data);
+
+  auto &result_validity = FlatVector::Validity(result);
+  auto result_data = FlatVector::GetData<list_entry_t>(result);
+
+  idx_t childOffset = ListVector::GetListSize(result);
+  idx_t total = 0;
+  for (idx_t i = 0; i < count; i++) {
+    auto &state = *states[state_data.sel->get_index(i)];
+    if (state.cells) {
+      total += state.cells->size();
+    }
+  }
+  ListVector::Reserve(result, childOffset + total);
+  auto child_data = FlatVector::GetData<T>(ListVector::GetEntry(result));
+
+  for (idx_t i = 0; i < count; i++) {
+    auto &state = *states[state_data.sel->get_index(i)];
+    auto rid = i + offset;
+    if (!state.cells) {
+      result_validity.SetInvalid(rid);
+      continue;
+    }
+    result_data[rid].offset = childOffset;
+    for (auto cell : *state.cells) {
+      child_data[childOffset++] = cell;
+    }
+    result_data[rid].length = state.cells->size();
+  }
+  ListVector::SetListSize(result, childOffset);
+  result.Verify(count);
+}
+
+template <typename T>
+static AggregateFunction GetTrajectoryCellsAggregate(const LogicalType &type) {
+  AggregateFunction fun(
+      {type}, LogicalType::LIST(type),
+      AggregateFunction::StateSize<TrajectoryCellsState>,
+      AggregateFunction::StateInitialize<TrajectoryCellsState,
+                                         TrajectoryCellsOperation>,
+      AggregateFunction::UnaryScatterUpdate<TrajectoryCellsState, T,
+                                            TrajectoryCellsOperation>,
+      AggregateFunction::StateCombine<TrajectoryCellsState,
+                                      TrajectoryCellsOperation>,
+      TrajectoryCellsFinalize<T>,
+      AggregateFunction::UnaryUpdate<TrajectoryCellsState, T,
+                                     TrajectoryCellsOperation>,
+      nullptr,
+      AggregateFunction::StateDestroy<TrajectoryCellsState,
+                                      TrajectoryCellsOperation>);
+  fun.order_dependent = AggregateOrderDependent::ORDER_DEPENDENT;
+  return fun;
+}
+
+// Grid distance from an origin to many destinations. gridDistance computes
+// the local IJ coordinates of the origin (anchored on itself) for every pair;
+// here they are computed once per distinct origin, and only the destination
+// is converted per call.
+class GridDistanceAnchor {
+public:
+  H3Error Distance(H3Index origin, H3Index destination, int64_t &out) {
+    if (origin != anchor || !initialized) {
+      anchor = origin;
+      initialized = true;
+      anchorErr = cellToLocalIj(origin, origin, 0, &anchorIj);
+    }
+    if (anchorErr) {
+      return anchorErr;
+    }
+    CoordIJ destinationIj;
+    H3Error err = cellToLocalIj(origin, destination, 0, &destinationIj);
+    if (err) {
+      return err;
+    }
+    // Same as ijkDistance after converting IJ to IJK
+    int64_t di = int64_t(destinationIj.i) - anchorIj.i;
+    int64_t dj = int64_t(destinationIj.j) - anchorIj.j;
+    if ((di >= 0) == (dj >= 0)) {
+      out = MaxValue(std::abs(di), std::abs(dj));
+    } else {
+      out = std::abs(di) + std::abs(dj);
+    }
+    return E_SUCCESS;
+  }
+
+private:
+  bool initialized = false;
+  H3Index anchor = H3_NULL;
+  H3Error anchorErr = E_SUCCESS;
+  CoordIJ anchorIj;
+};
+
 template <typename T>
 static void GridDistanceFunction(DataChunk &args, ExpressionState &state,
                                  Vector &result) {
   auto &inputs = args.data[0];
   auto &inputs2 = args.data[1];
+  GridDistanceAnchor anchor;
   BinaryExecutor::ExecuteWithNulls<T, T, int64_t>(
       inputs, inputs2, result, args.size(),
       [&](T origin, T destination, ValidityMask &mask, idx_t idx) {
         int64_t distance;
-        H3Error err = gridDistance(origin, destination, &distance);
+        H3Error err = anchor.Distance(origin, destination, distance);
         if (err) {
           mask.SetInvalid(idx);
           return int64_t(0);
@@ -510,10 +1063,80 @@ static void GridDistanceFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
+template <typename T>
+static void GridDistanceManyFunction(DataChunk &args, ExpressionState &state,
+                                     Vector &result) {
+  auto count = args.size();
+  UnifiedVectorFormat origin_data;
+  args.data[0].ToUnifiedFormat(count, origin_data);
+  auto origins = UnifiedVectorFormat::GetData<T>(origin_data);
+
+  auto &lists = args.data[1];
+  UnifiedVectorFormat lists_data;
+  lists.ToUnifiedFormat(count, lists_data);
+  auto list_entries = UnifiedVectorFormat::GetData<list_entry_t>(lists_data);
+
+  auto &child_vector = ListVector::GetEntry(lists);
+  UnifiedVectorFormat child_data;
+  child_vector.ToUnifiedFormat(ListVector::GetListSize(lists), child_data);
+  auto destinations = UnifiedVectorFormat::GetData<T>(child_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_entries = FlatVector::GetData<list_entry_t>(result);
+  auto &result_validity = FlatVector::Validity(result);
+
+  idx_t total = 0;
+  for (idx_t i = 0; i < count; i++) {
+    auto list_index = lists_data.sel->get_index(i);
+    if (lists_data.validity.RowIsValid(list_index)) {
+      total += list_entries[list_index].length;
+    }
+  }
+  idx_t offset = ListVector::GetListSize(result);
+  ListVector::Reserve(result, offset + total);
+  auto &result_child = ListVector::GetEntry(result);
+  auto distances = FlatVector::GetData<int64_t>(result_child);
+  auto &distances_validity = FlatVector::Validity(result_child);
+
+  GridDistanceAnchor anchor;
+  for (idx_t i = 0; i < count; i++) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 0;
+
+    auto origin_index = origin_data.sel->get_index(i);
+    auto list_index = lists_data.sel->get_index(i);
+    if (!origin_data.validity.RowIsValid(origin_index) ||
+        !lists_data.validity.RowIsValid(list_index)) {
+      result_validity.SetInvalid(i);
+      continue;
+    }
+
+    H3Index origin = origins[origin_index];
+    auto &entry = list_entries[list_index];
+    for (idx_t j = entry.offset; j < entry.offset + entry.length; j++) {
+      auto child_index = child_data.sel->get_index(j);
+      if (!child_data.validity.RowIsValid(child_index) ||
+          anchor.Distance(origin, destinations[child_index],
+                          distances[offset])) {
+        distances_validity.SetInvalid(offset);
+      }
+      offset++;
+    }
+    result_entries[i].length = entry.length;
+  }
+  ListVector::SetListSize(result, offset);
+
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(count);
+}
+
 static void GridDistanceVarcharFunction(DataChunk &args, ExpressionState &state,
                                         Vector &result) {
   auto &inputs = args.data[0];
   auto &inputs2 = args.data[1];
+  GridDistanceAnchor anchor;
   BinaryExecutor::ExecuteWithNulls<string_t, string_t, int64_t>(
       inputs, inputs2, result, args.size(),
       [&](string_t originInput, string_t destinationInput, ValidityMask &mask,
@@ -527,7 +1150,7 @@ static void GridDistanceVarcharFunction(DataChunk &args, ExpressionState &state,
           return int64_t(0);
         } else {
           int64_t distance;
-          H3Error err = gridDistance(origin, destination, &distance);
+          H3Error err = anchor.Distance(origin, destination, distance);
           if (err) {
             mask.SetInvalid(idx);
             return int64_t(0);
@@ -538,30 +1161,138 @@ static void GridDistanceVarcharFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
-static void CellToLocalIjFunction(DataChunk &args, ExpressionState &state,
-                                  Vector &result) {
-  auto result_data = FlatVector::GetData<list_entry_t>(result);
-  for (idx_t i = 0; i < args.size(); i++) {
-    result_data[i].offset = ListVector::GetListSize(result);
-
-    uint64_t origin = args.GetValue(0, i)
-                          .DefaultCastAs(LogicalType::UBIGINT)
-                          .GetValue<uint64_t>();
-    uint64_t cell = args.GetValue(1, i)
-                        .DefaultCastAs(LogicalType::UBIGINT)
-                        .GetValue<uint64_t>();
-    uint32_t mode = 0; // TODO: Expose mode to the user when applicable
+// Calls writer.Write(i, ij) for every row where cellToLocalIj succeeds, and
+// writer.SetNull(i) otherwise. When the origin is constant (e.g. rasterizing
+// an area around one cell), it is read once, and cells at another resolution
+// are rejected without calling into the library. The origin's frame is not
+// cached: cellToLocalIj only reads the origin's base cell and leading digit,
+// and its cost is in unfolding the other cell from that base cell, which
+// differs per row. Caching would mean copying h3lib's internal localij logic
+// for a saving of a few table lookups per row.
+template <typename T, class WRITER>
+static void CellToLocalIjExecute(DataChunk &args, WRITER &writer) {
+  auto count = args.size();
+  uint32_t mode = 0; // TODO: Expose mode to the user when applicable
+
+  UnifiedVectorFormat cell_data;
+  args.data[1].ToUnifiedFormat(count, cell_data);
+  auto cells = UnifiedVectorFormat::GetData<T>(cell_data);
+
+  if (args.data[0].GetVectorType() == VectorType::CONSTANT_VECTOR) {
+    if (ConstantVector::IsNull(args.data[0])) {
+      for (idx_t i = 0; i < count; i++) {
+        writer.SetNull(i);
+      }
+      return;
+    }
+    H3Index origin = *ConstantVector::GetData<T>(args.data[0]);
+    int originRes = getResolution(origin);
+    for (idx_t i = 0; i < count; i++) {
+      auto cell_index = cell_data.sel->get_index(i);
+      CoordIJ out;
+      if (!cell_data.validity.RowIsValid(cell_index) ||
+          getResolution(cells[cell_index]) != originRes ||
+          cellToLocalIj(origin, cells[cell_index], mode, &out)) {
+        writer.SetNull(i);
+      } else {
+        writer.Write(i, out);
+      }
+    }
+    return;
+  }
 
+  UnifiedVectorFormat origin_data;
+  args.data[0].ToUnifiedFormat(count, origin_data);
+  auto origins = UnifiedVectorFormat::GetData<T>(origin_data);
+  for (idx_t i = 0; i < count; i++) {
+    auto origin_index = origin_data.sel->get_index(i);
+    auto cell_index = cell_data.sel->get_index(i);
     CoordIJ out;
-    H3Error err = cellToLocalIj(origin, cell, mode, &out);
-    if (err) {
-      result.SetValue(i, Value(LogicalType::SQLNULL));
+    if (!origin_data.validity.RowIsValid(origin_index) ||
+        !cell_data.validity.RowIsValid(cell_index) ||
+        cellToLocalIj(origins[origin_index], cells[cell_index], mode, &out)) {
+      writer.SetNull(i);
     } else {
-      ListVector::PushBack(result, Value::INTEGER(out.i));
-      ListVector::PushBack(result, Value::INTEGER(out.j));
-      result_data[i].length = 2;
+      writer.Write(i, out);
     }
   }
+}
+
+// Writes local IJ coordinates as LIST(INTEGER) [i, j]
+struct CellToLocalIjListWriter {
+  CellToLocalIjListWriter(Vector &result, idx_t count)
+      : result_entries(FlatVector::GetData<list_entry_t>(result)),
+        result_validity(FlatVector::Validity(result)),
+        offset(ListVector::GetListSize(result)) {
+    ListVector::Reserve(result, offset + count * 2);
+    child_data = FlatVector::GetData<int32_t>(ListVector::GetEntry(result));
+  }
+
+  void Write(idx_t i, const CoordIJ &ij) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 2;
+    child_data[offset++] = ij.i;
+    child_data[offset++] = ij.j;
+  }
+
+  void SetNull(idx_t i) {
+    result_entries[i].offset = offset;
+    result_entries[i].length = 0;
+    result_validity.SetInvalid(i);
+  }
+
+  list_entry_t *result_entries;
+  ValidityMask &result_validity;
+  int32_t *child_data;
+  idx_t offset;
+};
+
+// Writes local IJ coordinates as STRUCT(i INTEGER, j INTEGER)
+struct CellToLocalIjStructWriter {
+  explicit CellToLocalIjStructWriter(Vector &result)
+      : result_validity(FlatVector::Validity(result)),
+        i_vector(*StructVector::GetEntries(result)[0]),
+        j_vector(*StructVector::GetEntries(result)[1]),
+        i_data(FlatVector::GetData<int32_t>(i_vector)),
+        j_data(FlatVector::GetData<int32_t>(j_vector)) {}
+
+  void Write(idx_t i, const CoordIJ &ij) {
+    i_data[i] = ij.i;
+    j_data[i] = ij.j;
+  }
+
+  void SetNull(idx_t i) {
+    result_validity.SetInvalid(i);
+    FlatVector::SetNull(i_vector, i, true);
+    FlatVector::SetNull(j_vector, i, true);
+  }
+
+  ValidityMask &result_validity;
+  Vector &i_vector;
+  Vector &j_vector;
+  int32_t *i_data;
+  int32_t *j_data;
+};
+
+template <typename T>
+static void CellToLocalIjFunction(DataChunk &args, ExpressionState &state,
+                                  Vector &result) {
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  CellToLocalIjListWriter writer(result, args.size());
+  CellToLocalIjExecute<T>(args, writer);
+  ListVector::SetListSize(result, writer.offset);
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(args.size());
+}
+
+template <typename T>
+static void CellToLocalIjStructFunction(DataChunk &args, ExpressionState &state,
+                                        Vector &result) {
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  CellToLocalIjStructWriter writer(result);
+  CellToLocalIjExecute<T>(args, writer);
   if (args.AllConstant()) {
     result.SetVectorType(VectorType::CONSTANT_VECTOR);
   }
@@ -594,6 +1325,7 @@ static void CellToLocalIjVarcharFunction(DataChunk &args,
       if (err2) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         ListVector::PushBack(result, Value::INTEGER(out.i));
         ListVector::PushBack(result, Value::INTEGER(out.j));
         result_data[i].length = 2;
@@ -629,6 +1361,64 @@ static void LocalIjToCellFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
+// h3_local_ij_to_cell(origin, STRUCT(i, j)), the inverse of
+// h3_cell_to_local_ij_struct. As there, a constant origin is read once.
+template <typename T>
+static void LocalIjStructToCellFunction(DataChunk &args, ExpressionState &state,
+                                        Vector &result) {
+  auto count = args.size();
+  uint32_t mode = 0; // TODO: Expose mode to the user when applicable
+
+  // The entries of a dictionary STRUCT are those of its child, so it is
+  // flattened. Entries of a constant or flat STRUCT are read at its index.
+  auto &ij_vector = args.data[1];
+  if (ij_vector.GetVectorType() == VectorType::DICTIONARY_VECTOR) {
+    ij_vector.Flatten(count);
+  }
+  UnifiedVectorFormat ij_data, i_data, j_data;
+  ij_vector.ToUnifiedFormat(count, ij_data);
+  auto &ij_entries = StructVector::GetEntries(ij_vector);
+  ij_entries[0]->ToUnifiedFormat(count, i_data);
+  ij_entries[1]->ToUnifiedFormat(count, j_data);
+  auto is = UnifiedVectorFormat::GetData<int32_t>(i_data);
+  auto js = UnifiedVectorFormat::GetData<int32_t>(j_data);
+
+  bool constantOrigin =
+      args.data[0].GetVectorType() == VectorType::CONSTANT_VECTOR;
+  UnifiedVectorFormat origin_data;
+  args.data[0].ToUnifiedFormat(count, origin_data);
+  auto origins = UnifiedVectorFormat::GetData<T>(origin_data);
+
+  result.SetVectorType(VectorType::FLAT_VECTOR);
+  auto result_data = FlatVector::GetData<T>(result);
+  auto &result_validity = FlatVector::Validity(result);
+
+  for (idx_t row = 0; row < count; row++) {
+    auto origin_index = constantOrigin ? 0 : origin_data.sel->get_index(row);
+    auto ij_index = ij_data.sel->get_index(row);
+    auto i_index = i_data.sel->get_index(ij_index);
+    auto j_index = j_data.sel->get_index(ij_index);
+    if (!origin_data.validity.RowIsValid(origin_index) ||
+        !ij_data.validity.RowIsValid(ij_index) ||
+        !i_data.validity.RowIsValid(i_index) ||
+        !j_data.validity.RowIsValid(j_index)) {
+      result_validity.SetInvalid(row);
+      continue;
+    }
+    CoordIJ coordIJ{.i = is[i_index], .j = js[j_index]};
+    H3Index out;
+    if (localIjToCell(origins[origin_index], &coordIJ, mode, &out)) {
+      result_validity.SetInvalid(row);
+    } else {
+      result_data[row] = out;
+    }
+  }
+  if (args.AllConstant()) {
+    result.SetVectorType(VectorType::CONSTANT_VECTOR);
+  }
+  result.Verify(count);
+}
+
 static void LocalIjToCellVarcharFunction(DataChunk &args,
                                          ExpressionState &state,
                                          Vector &result) {
@@ -653,6 +1443,7 @@ static void LocalIjToCellVarcharFunction(DataChunk &args,
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", out);
             return StringVector::AddString(result, str);
           }
@@ -677,21 +1468,26 @@ static void MaxGridDiskSizeFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
+static ScalarFunction GetAdaptiveGridDiskFunction(const LogicalType &type,
+                                                  scalar_function_t function) {
+  ScalarFunction fun({type, LogicalType::INTEGER}, LogicalType::LIST(type),
+                     function);
+  fun.init_local_state = GridDiskLocalState::Init;
+  return fun;
+}
+
 CreateScalarFunctionInfo H3Functions::GetGridDiskFunction() {
   ScalarFunctionSet funcs("h3_grid_disk");
-  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
-                                   LogicalType::LIST(LogicalType::UBIGINT),
-                                   GridDiskTmplFunction<GridDiskOperator>));
-  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::INTEGER},
-                                   LogicalType::LIST(LogicalType::BIGINT),
-                                   GridDiskTmplFunction<GridDiskOperator>));
-  funcs.AddFunction(
-      ScalarFunction({LogicalType::VARCHAR, LogicalType::INTEGER},
-                     LogicalType::LIST(LogicalType::VARCHAR),
-                     GridDiskTmplVarcharFunction<GridDiskOperator>));
+  funcs.AddFunction(GetAdaptiveGridDiskFunction(LogicalType::UBIGINT,
+                                                GridDiskFunction<uint64_t>));
+  funcs.AddFunction(GetAdaptiveGridDiskFunction(LogicalType::BIGINT,
+                                                GridDiskFunction<int64_t>));
+  funcs.AddFunction(GetAdaptiveGridDiskFunction(LogicalType::VARCHAR,
+                                                GridDiskVarcharFunction));
   return CreateScalarFunctionInfo(funcs);
 }
 
+
 CreateScalarFunctionInfo H3Functions::GetMaxGridDiskSizeFunction() {
   ScalarFunctionSet funcs("h3_max_grid_disk_size");
   funcs.AddFunction(ScalarFunction({LogicalType::INTEGER}, LogicalType::BIGINT,
@@ -799,16 +1595,33 @@ CreateScalarFunctionInfo H3Functions::GetGridPathCellsFunction() {
   ScalarFunctionSet funcs("h3_grid_path_cells");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::UBIGINT},
                                    LogicalType::LIST(LogicalType::UBIGINT),
-                                   GridPathCellsFunction));
+                                   GridPathCellsFunction<uint64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::BIGINT},
                                    LogicalType::LIST(LogicalType::BIGINT),
-                                   GridPathCellsFunction));
+                                   GridPathCellsFunction<int64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
                                    LogicalType::LIST(LogicalType::VARCHAR),
                                    GridPathCellsVarcharFunction));
   return CreateScalarFunctionInfo(funcs);
 }
 
+TableFunctionSet H3Functions::GetGridPathCellsStreamFunction() {
+  TableFunctionSet funcs("h3_grid_path_cells_stream");
+  TableFunction fun({LogicalType::TABLE}, nullptr, GridPathCellsStreamBind,
+                    nullptr, GridPathCellsStreamInitLocal);
+  fun.in_out_function = GridPathCellsStreamFunction;
+  funcs.AddFunction(fun);
+  return funcs;
+}
+
+AggregateFunctionSet H3Functions::GetTrajectoryCellsAggFunction() {
+  AggregateFunctionSet funcs("h3_trajectory_cells_agg");
+  funcs.AddFunction(
+      GetTrajectoryCellsAggregate<uint64_t>(LogicalType::UBIGINT));
+  funcs.AddFunction(GetTrajectoryCellsAggregate<int64_t>(LogicalType::BIGINT));
+  return funcs;
+}
+
 CreateScalarFunctionInfo H3Functions::GetGridDistanceFunction() {
   ScalarFunctionSet funcs("h3_grid_distance");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::UBIGINT},
@@ -823,20 +1636,51 @@ CreateScalarFunctionInfo H3Functions::GetGridDistanceFunction() {
   return CreateScalarFunctionInfo(funcs);
 }
 
+CreateScalarFunctionInfo H3Functions::GetGridDistanceManyFunction() {
+  ScalarFunctionSet funcs("h3_grid_distance_many");
+  funcs.AddFunction(ScalarFunction(
+      {LogicalType::UBIGINT, LogicalType::LIST(LogicalType::UBIGINT)},
+      LogicalType::LIST(LogicalType::BIGINT),
+      GridDistanceManyFunction<uint64_t>));
+  funcs.AddFunction(ScalarFunction(
+      {LogicalType::BIGINT, LogicalType::LIST(LogicalType::BIGINT)},
+      LogicalType::LIST(LogicalType::BIGINT),
+      GridDistanceManyFunction<int64_t>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
 CreateScalarFunctionInfo H3Functions::GetCellToLocalIjFunction() {
   ScalarFunctionSet funcs("h3_cell_to_local_ij");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::UBIGINT},
                                    LogicalType::LIST(LogicalType::INTEGER),
-                                   CellToLocalIjFunction));
+                                   CellToLocalIjFunction<uint64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::BIGINT},
                                    LogicalType::LIST(LogicalType::INTEGER),
-                                   CellToLocalIjFunction));
+                                   CellToLocalIjFunction<int64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::VARCHAR},
                                    LogicalType::LIST(LogicalType::VARCHAR),
                                    CellToLocalIjVarcharFunction));
   return CreateScalarFunctionInfo(funcs);
 }
 
+static LogicalType LocalIjType() {
+  child_list_t<LogicalType> children;
+  children.emplace_back("i", LogicalType::INTEGER);
+  children.emplace_back("j", LogicalType::INTEGER);
+  return LogicalType::STRUCT(children);
+}
+
+CreateScalarFunctionInfo H3Functions::GetCellToLocalIjStructFunction() {
+  ScalarFunctionSet funcs("h3_cell_to_local_ij_struct");
+  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::UBIGINT},
+                                   LocalIjType(),
+                                   CellToLocalIjStructFunction<uint64_t>));
+  funcs.AddFunction(ScalarFunction({LogicalType::BIGINT, LogicalType::BIGINT},
+                                   LocalIjType(),
+                                   CellToLocalIjStructFunction<int64_t>));
+  return CreateScalarFunctionInfo(funcs);
+}
+
 CreateScalarFunctionInfo H3Functions::GetLocalIjToCellFunction() {
   ScalarFunctionSet funcs("h3_local_ij_to_cell");
   funcs.AddFunction(ScalarFunction(
@@ -848,6 +1692,12 @@ CreateScalarFunctionInfo H3Functions::GetLocalIjToCellFunction() {
   funcs.AddFunction(ScalarFunction(
       {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::INTEGER},
       LogicalType::VARCHAR, LocalIjToCellVarcharFunction));
+  funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LocalIjType()},
+                                   LogicalType::UBIGINT,
+                                   LocalIjStructToCellFunction<uint64_t>));
+  funcs.AddFunction(
+      ScalarFunction({LogicalType::BIGINT, LocalIjType()}, LogicalType::BIGINT,
+                     LocalIjStructToCellFunction<int64_t>));
   return CreateScalarFunctionInfo(funcs);
 }
 
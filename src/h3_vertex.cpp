@@ -1,5 +1,6 @@
 #include "h3_common.hpp"
 #include "h3_functions.hpp"
+#include "h3_stats.hpp"
 
 namespace duckdb {
 
@@ -42,6 +43,7 @@ static void CellToVertexVarcharFunction(DataChunk &args, ExpressionState &state,
             mask.SetInvalid(idx);
             return StringVector::EmptyString(result, 0);
           } else {
+            H3StatsMaterialize materialize;
             auto str = StringUtil::Format("%llx", vertex);
             return StringVector::AddString(result, str);
           }
@@ -49,43 +51,49 @@ static void CellToVertexVarcharFunction(DataChunk &args, ExpressionState &state,
       });
 }
 
+template <typename T>
 static void CellToVertexesFunction(DataChunk &args, ExpressionState &state,
                                    Vector &result) {
+  auto count = args.size();
+  UnifiedVectorFormat input_data;
+  args.data[0].ToUnifiedFormat(count, input_data);
+  auto inputs = UnifiedVectorFormat::GetData<T>(input_data);
+
   result.SetVectorType(VectorType::FLAT_VECTOR);
   auto &result_validity = FlatVector::Validity(result);
   auto result_data = FlatVector::GetData<list_entry_t>(result);
-  idx_t offset = 0;
-  for (idx_t i = 0; i < args.size(); i++) {
-    result_data[i].offset = offset;
 
-    uint64_t cell = args.GetValue(0, i)
-                        .DefaultCastAs(LogicalType::UBIGINT)
-                        .GetValue<uint64_t>();
+  // Vertexes are written straight into the list child vector, reserved up
+  // front for six per cell.
+  idx_t offset = ListVector::GetListSize(result);
+  ListVector::Reserve(result, offset + count * 6);
+  auto child_data = FlatVector::GetData<T>(ListVector::GetEntry(result));
+
+  for (idx_t i = 0; i < count; i++) {
+    result_data[i].offset = offset;
+    result_data[i].length = 0;
 
-    int64_t actual = 0;
-    std::vector<H3Index> out(6);
-    H3Error err = cellToVertexes(cell, out.data());
-    if (err) {
+    auto idx = input_data.sel->get_index(i);
+    H3Index vertexes[6];
+    if (!input_data.validity.RowIsValid(idx) ||
+        cellToVertexes(inputs[idx], vertexes)) {
       result_validity.SetInvalid(i);
-      result_data[i].length = 0;
-    } else {
-      for (auto val : out) {
-        if (val != H3_NULL) {
-          auto result_val = Value::UBIGINT(val);
-          ListVector::PushBack(result, result_val);
-          actual++;
-        }
+      continue;
+    }
+    for (auto vertex : vertexes) {
+      // Pentagons have only five vertexes
+      if (vertex != H3_NULL) {
+        child_data[offset++] = vertex;
       }
-
-      result_data[i].length = actual;
     }
-    offset += actual;
+    result_data[i].length = offset - result_data[i].offset;
   }
+  ListVector::SetListSize(result, offset);
 
   if (args.AllConstant()) {
     result.SetVectorType(VectorType::CONSTANT_VECTOR);
   }
-  result.Verify(args.size());
+  result.Verify(count);
 }
 
 static void CellToVertexesVarcharFunction(DataChunk &args,
@@ -115,6 +123,7 @@ static void CellToVertexesVarcharFunction(DataChunk &args,
         result_validity.SetInvalid(i);
         result_data[i].length = 0;
       } else {
+        H3StatsMaterialize materialize;
         for (auto val : out) {
           if (val != H3_NULL) {
             auto str = StringUtil::Format("%llx", val);
@@ -232,6 +241,7 @@ static void VertexToLatLngFunction(DataChunk &args, ExpressionState &state,
     H3Error err = vertexToLatLng(vertex, &latLng);
     ThrowH3Error(err);
 
+    H3StatsMaterialize materialize;
     ListVector::PushBack(result, radsToDegs(latLng.lat));
     ListVector::PushBack(result, radsToDegs(latLng.lng));
     result_data[i].length = 2;
@@ -262,6 +272,7 @@ static void VertexToLatLngVarcharFunction(DataChunk &args,
       if (err1) {
         result.SetValue(i, Value(LogicalType::SQLNULL));
       } else {
+        H3StatsMaterialize materialize;
         ListVector::PushBack(result, radsToDegs(latLng.lat));
         ListVector::PushBack(result, radsToDegs(latLng.lng));
         result_data[i].length = 2;
@@ -298,6 +309,123 @@ static void IsValidVertexFunction(DataChunk &args, ExpressionState &state,
   });
 }
 
+// Aggregate state for h3_distinct_vertexes_agg. The set is only allocated
+// once the group sees its first cell.
+struct DistinctVertexesState {
+  unordered_set<H3Index> *vertexes;
+};
+
+struct DistinctVertexesOperation {
+  template <class STATE> static void Initialize(STATE &state) {
+    state.vertexes = nullptr;
+  }
+
+  template <class STATE>
+  static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+    delete state.vertexes;
+    state.vertexes = nullptr;
+  }
+
+  static bool IgnoreNull() { return true; }
+
+  template <class INPUT_TYPE, class STATE, class OP>
+  static void Operation(STATE &state, const INPUT_TYPE &input,
+                        AggregateUnaryInput &unary_input) {
+    if (!state.vertexes) {
+      state.vertexes = new unordered_set<H3Index>();
+    }
+    H3Index vertexes[6];
+    if (cellToVertexes(input, vertexes)) {
+      return;
+    }
+    for (auto vertex : vertexes) {
+      if (vertex != H3_NULL) {
+        state.vertexes->insert(vertex);
+      }
+    }
+  }
+
+  template <class INPUT_TYPE, class STATE, class OP>
+  static void ConstantOperation(STATE &state, const INPUT_TYPE &input,
+                                AggregateUnaryInput &unary_input,
+                                idx_t count) {
+    Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+  }
+
+  template <class STATE, class OP>
+  static void Combine(const STATE &source, STATE &target,
+                      AggregateInputData &aggr_input_data) {
+    if (!source.vertexes) {
+      return;
+    }
+    if (!target.vertexes) {
+      target.vertexes = new unordered_set<H3Index>(*source.vertexes);
+      return;
+    }
+    target.vertexes->insert(source.vertexes->begin(), source.vertexes->end());
+  }
+};
+
+template <typename T>
+static void DistinctVertexesFinalize(Vector &state_vector,
+                                     AggregateInputData &aggr_input_data,
+                                     Vector &result, idx_t count,
+                                     idx_t offset) {
+  UnifiedVectorFormat state_data;
+  state_vector.ToUnifiedFormat(count, state_data);
+  auto states =
+      UnifiedVectorFormat::GetData<DistinctVertexesState *>(state_data);
+
+  auto &result_validity = FlatVector::Validity(result);
+  auto result_data = FlatVector::GetData<list_entry_t>(result);
+
+  idx_t childOffset = ListVector::GetListSize(result);
+  idx_t total = 0;
+  for (idx_t i = 0; i < count; i++) {
+    auto &state = *states[state_data.sel->get_index(i)];
+    if (state.vertexes) {
+      total += state.vertexes->size();
+    }
+  }
+  ListVector::Reserve(result, childOffset + total);
+  auto child_data = FlatVector::GetData<T>(ListVector::GetEntry(result));
+
+  for (idx_t i = 0; i < count; i++) {
+    auto &state = *states[state_data.sel->get_index(i)];
+    auto rid = i + offset;
+    if (!state.vertexes) {
+      result_validity.SetInvalid(rid);
+      continue;
+    }
+    result_data[rid].offset = childOffset;
+    for (auto vertex : *state.vertexes) {
+      child_data[childOffset++] = vertex;
+    }
+    result_data[rid].length = state.vertexes->size();
+  }
+  ListVector::SetListSize(result, childOffset);
+  result.Verify(count);
+}
+
+template <typename T>
+static AggregateFunction GetDistinctVertexesAggregate(const LogicalType &type) {
+  return AggregateFunction(
+      {type}, LogicalType::LIST(type),
+      AggregateFunction::StateSize<DistinctVertexesState>,
+      AggregateFunction::StateInitialize<DistinctVertexesState,
+                                         DistinctVertexesOperation>,
+      AggregateFunction::UnaryScatterUpdate<DistinctVertexesState, T,
+                                            DistinctVertexesOperation>,
+      AggregateFunction::StateCombine<DistinctVertexesState,
+                                      DistinctVertexesOperation>,
+      DistinctVertexesFinalize<T>,
+      AggregateFunction::UnaryUpdate<DistinctVertexesState, T,
+                                     DistinctVertexesOperation>,
+      nullptr,
+      AggregateFunction::StateDestroy<DistinctVertexesState,
+                                      DistinctVertexesOperation>);
+}
+
 CreateScalarFunctionInfo H3Functions::GetCellToVertexFunction() {
   ScalarFunctionSet funcs("h3_cell_to_vertex");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT, LogicalType::INTEGER},
@@ -316,10 +444,10 @@ CreateScalarFunctionInfo H3Functions::GetCellToVertexesFunction() {
   ScalarFunctionSet funcs("h3_cell_to_vertexes");
   funcs.AddFunction(ScalarFunction({LogicalType::UBIGINT},
                                    LogicalType::LIST(LogicalType::UBIGINT),
-                                   CellToVertexesFunction));
+                                   CellToVertexesFunction<uint64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::BIGINT},
                                    LogicalType::LIST(LogicalType::BIGINT),
-                                   CellToVertexesFunction));
+                                   CellToVertexesFunction<int64_t>));
   funcs.AddFunction(ScalarFunction({LogicalType::VARCHAR},
                                    LogicalType::LIST(LogicalType::VARCHAR),
                                    CellToVertexesVarcharFunction));
@@ -373,4 +501,12 @@ CreateScalarFunctionInfo H3Functions::GetIsValidVertexFunctions() {
   return CreateScalarFunctionInfo(funcs);
 }
 
+AggregateFunctionSet H3Functions::GetDistinctVertexesAggFunction() {
+  AggregateFunctionSet funcs("h3_distinct_vertexes_agg");
+  funcs.AddFunction(
+      GetDistinctVertexesAggregate<uint64_t>(LogicalType::UBIGINT));
+  funcs.AddFunction(GetDistinctVertexesAggregate<int64_t>(LogicalType::BIGINT));
+  return funcs;
+}
+
 } // namespace duckdb
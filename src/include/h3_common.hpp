@@ -8,10 +8,69 @@
 
 #pragma once
 
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/planner/expression.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
 #include "h3api.h"
 
+extern "C" {
+#include "constants.h"
+}
+
 namespace duckdb {
 
 void ThrowH3Error(H3Error err);
 
+// Evaluates a bind-time constant argument (for example, a unit or flags
+// string). Returns false if the argument is not foldable or is NULL, in which
+// case it has to be resolved per row.
+bool TryGetConstantArgument(ClientContext &context, Expression &arg,
+                            Value &out);
+
+// Minimum and maximum of a UBIGINT or BIGINT cell argument, from its
+// statistics. Returns false if they are unknown, or negative.
+bool TryGetCellRange(const BaseStatistics &stats, H3Index &min, H3Index &max);
+
+// H3SET, a BLOB holding a compressed, sorted set of cells (see h3_sets.cpp)
+LogicalType H3SetType();
+
+// Smallest and largest index of the children of a cell at res. The children
+// at one resolution are the valid cells between those bounds.
+H3Error CellToChildrenRange(H3Index cell, int res, H3Index &min, H3Index &max);
+
+// A cell and the range of its descendants at the finest resolution. The
+// ranges of two cells are either disjoint, or nested when one cell is an
+// ancestor of the other.
+struct CellSpan {
+  H3Index cell;
+  H3Index min;
+  H3Index max;
+
+  static CellSpan Of(H3Index cell) {
+    CellSpan span{cell, 0, 0};
+    CellToChildrenRange(cell, MAX_H3_RES, span.min, span.max);
+    return span;
+  }
+
+  bool Covers(const CellSpan &other) const {
+    return min <= other.min && other.max <= max;
+  }
+
+  bool Overlaps(const CellSpan &other) const {
+    return min <= other.max && other.min <= max;
+  }
+};
+
+// Orders spans by their start, coarser cells first
+bool SpanBefore(const CellSpan &a, const CellSpan &b);
+
+// Keeps the spans not covered by a previous one. The spans must be sorted by
+// SpanBefore, and the result is sorted and disjoint.
+void RemoveCoveredSpans(vector<CellSpan> &spans);
+
+// Replaces each complete set of siblings with their parent, until none is
+// left. The spans must be sorted and disjoint.
+void CompactSpans(vector<CellSpan> &spans);
+
 } // namespace duckdb
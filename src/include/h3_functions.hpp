@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include "duckdb/function/aggregate_function.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/parser/parsed_data/create_macro_info.hpp"
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 
 namespace duckdb {
@@ -47,8 +50,14 @@ public:
     functions.push_back(GetCellToCenterChildFunction());
     functions.push_back(GetCellToChildPosFunction());
     functions.push_back(GetChildPosToCellFunction());
+    functions.push_back(GetCellToAncestorsFunction());
+    functions.push_back(GetCellToSortKeyFunction());
+    functions.push_back(GetSortKeyToCellFunction());
     functions.push_back(GetCompactCellsFunction());
     functions.push_back(GetUncompactCellsFunction());
+    functions.push_back(GetCellsIntersectionFunction());
+    functions.push_back(GetCellsUnionFunction());
+    functions.push_back(GetCellsDifferenceFunction());
 
     // Traversal
     functions.push_back(GetGridDiskFunction());
@@ -60,8 +69,10 @@ public:
     functions.push_back(GetGridRingUnsafeFunction());
     functions.push_back(GetGridPathCellsFunction());
     functions.push_back(GetGridDistanceFunction());
+    functions.push_back(GetGridDistanceManyFunction());
     functions.push_back(GetMaxGridDiskSizeFunction());
     functions.push_back(GetCellToLocalIjFunction());
+    functions.push_back(GetCellToLocalIjStructFunction());
     functions.push_back(GetLocalIjToCellFunction());
 
     // Directed edge
@@ -99,6 +110,7 @@ public:
     // Regions
     functions.push_back(GetCellsToMultiPolygonWktFunction());
     functions.push_back(GetCellsToMultiPolygonWkbFunction());
+    functions.push_back(GetCellsToMultiPolygonGeometryFunction());
     functions.push_back(GetPolygonWktToCellsFunction());
     functions.push_back(GetPolygonWktToCellsVarcharFunction());
     functions.push_back(GetPolygonWkbToCellsFunction());
@@ -107,6 +119,70 @@ public:
     functions.push_back(GetPolygonWktToCellsExperimentalVarcharFunction());
     functions.push_back(GetPolygonWkbToCellsExperimentalFunction());
     functions.push_back(GetPolygonWkbToCellsExperimentalVarcharFunction());
+    functions.push_back(GetPolygonWkbToCellsCompactFunction());
+    functions.push_back(GetTryPolygonWktToCellsFunction());
+    functions.push_back(GetTryPolygonWktToCellsVarcharFunction());
+    functions.push_back(GetTryPolygonWkbToCellsFunction());
+    functions.push_back(GetTryPolygonWkbToCellsVarcharFunction());
+    functions.push_back(GetTryPolygonWktToCellsExperimentalFunction());
+    functions.push_back(GetTryPolygonWktToCellsExperimentalVarcharFunction());
+    functions.push_back(GetTryPolygonWkbToCellsExperimentalFunction());
+    functions.push_back(GetTryPolygonWkbToCellsExperimentalVarcharFunction());
+    functions.push_back(GetPolygonValidateWkbFunction());
+    functions.push_back(GetPolygonWkbToCoveringFunction());
+    functions.push_back(GetPolygonWkbContainsPointFunction());
+
+    // Sets
+    functions.push_back(GetCellsToSetFunction());
+    functions.push_back(GetSetToCellsFunction());
+    functions.push_back(GetSetSizeFunction());
+    functions.push_back(GetSetContainsFunction());
+    functions.push_back(GetSetIntersectionFunction());
+    functions.push_back(GetSetUnionFunction());
+    functions.push_back(GetSetDifferenceFunction());
+
+    return functions;
+  }
+
+  static vector<TableFunctionSet> GetTableFunctions() {
+    vector<TableFunctionSet> functions;
+
+    // Traversal
+    functions.push_back(GetGridPathCellsStreamFunction());
+
+    // Stats
+    functions.push_back(GetStatsFunction());
+    functions.push_back(GetStatsResetFunction());
+
+    return functions;
+  }
+
+  static vector<unique_ptr<CreateMacroInfo>> GetTableMacros() {
+    vector<unique_ptr<CreateMacroInfo>> macros;
+
+    // Hierarchy
+    macros.push_back(GetContainmentJoinMacro());
+
+    // Directed edge
+    macros.push_back(GetCellsToEdgeGraphMacro());
+
+    // Regions
+    macros.push_back(GetPointsInPolygonsMacro());
+
+    return macros;
+  }
+
+  static vector<AggregateFunctionSet> GetAggregateFunctions() {
+    vector<AggregateFunctionSet> functions;
+
+    // Traversal
+    functions.push_back(GetTrajectoryCellsAggFunction());
+
+    // Vertex
+    functions.push_back(GetDistinctVertexesAggFunction());
+
+    // Sets
+    functions.push_back(GetSetAggFunction());
 
     return functions;
   }
@@ -142,8 +218,15 @@ private:
   static CreateScalarFunctionInfo GetCellToCenterChildFunction();
   static CreateScalarFunctionInfo GetCellToChildPosFunction();
   static CreateScalarFunctionInfo GetChildPosToCellFunction();
+  static CreateScalarFunctionInfo GetCellToAncestorsFunction();
+  static CreateScalarFunctionInfo GetCellToSortKeyFunction();
+  static CreateScalarFunctionInfo GetSortKeyToCellFunction();
+  static unique_ptr<CreateMacroInfo> GetContainmentJoinMacro();
   static CreateScalarFunctionInfo GetCompactCellsFunction();
   static CreateScalarFunctionInfo GetUncompactCellsFunction();
+  static CreateScalarFunctionInfo GetCellsIntersectionFunction();
+  static CreateScalarFunctionInfo GetCellsUnionFunction();
+  static CreateScalarFunctionInfo GetCellsDifferenceFunction();
 
   // Traversal
   static CreateScalarFunctionInfo GetGridDiskFunction();
@@ -154,9 +237,13 @@ private:
   static CreateScalarFunctionInfo GetGridRingFunction();
   static CreateScalarFunctionInfo GetGridRingUnsafeFunction();
   static CreateScalarFunctionInfo GetGridPathCellsFunction();
+  static TableFunctionSet GetGridPathCellsStreamFunction();
+  static AggregateFunctionSet GetTrajectoryCellsAggFunction();
   static CreateScalarFunctionInfo GetGridDistanceFunction();
+  static CreateScalarFunctionInfo GetGridDistanceManyFunction();
   static CreateScalarFunctionInfo GetMaxGridDiskSizeFunction();
   static CreateScalarFunctionInfo GetCellToLocalIjFunction();
+  static CreateScalarFunctionInfo GetCellToLocalIjStructFunction();
   static CreateScalarFunctionInfo GetLocalIjToCellFunction();
 
   // Directed edge
@@ -170,6 +257,7 @@ private:
   static CreateScalarFunctionInfo GetDirectedEdgeToBoundaryWktFunction();
   static CreateScalarFunctionInfo GetDirectedEdgeToBoundaryWkbFunction();
   static CreateScalarFunctionInfo GetReverseDirectedEdgeFunction();
+  static unique_ptr<CreateMacroInfo> GetCellsToEdgeGraphMacro();
 
   // Vertex
   static CreateScalarFunctionInfo GetCellToVertexFunction();
@@ -178,6 +266,7 @@ private:
   static CreateScalarFunctionInfo GetVertexToLngFunction();
   static CreateScalarFunctionInfo GetVertexToLatLngFunction();
   static CreateScalarFunctionInfo GetIsValidVertexFunctions();
+  static AggregateFunctionSet GetDistinctVertexesAggFunction();
 
   // Misc
   static CreateScalarFunctionInfo GetGetHexagonAreaAvgFunction();
@@ -194,6 +283,7 @@ private:
   // Regions
   static CreateScalarFunctionInfo GetCellsToMultiPolygonWktFunction();
   static CreateScalarFunctionInfo GetCellsToMultiPolygonWkbFunction();
+  static CreateScalarFunctionInfo GetCellsToMultiPolygonGeometryFunction();
   static CreateScalarFunctionInfo GetPolygonWktToCellsFunction();
   static CreateScalarFunctionInfo GetPolygonWktToCellsVarcharFunction();
   static CreateScalarFunctionInfo GetPolygonWkbToCellsFunction();
@@ -204,6 +294,33 @@ private:
   static CreateScalarFunctionInfo GetPolygonWkbToCellsExperimentalFunction();
   static CreateScalarFunctionInfo
   GetPolygonWkbToCellsExperimentalVarcharFunction();
+  static CreateScalarFunctionInfo GetPolygonWkbToCellsCompactFunction();
+  static CreateScalarFunctionInfo GetTryPolygonWktToCellsFunction();
+  static CreateScalarFunctionInfo GetTryPolygonWktToCellsVarcharFunction();
+  static CreateScalarFunctionInfo GetTryPolygonWkbToCellsFunction();
+  static CreateScalarFunctionInfo GetTryPolygonWkbToCellsVarcharFunction();
+  static CreateScalarFunctionInfo
+  GetTryPolygonWktToCellsExperimentalFunction();
+  static CreateScalarFunctionInfo
+  GetTryPolygonWktToCellsExperimentalVarcharFunction();
+  static CreateScalarFunctionInfo
+  GetTryPolygonWkbToCellsExperimentalFunction();
+  static CreateScalarFunctionInfo
+  GetTryPolygonWkbToCellsExperimentalVarcharFunction();
+  static CreateScalarFunctionInfo GetPolygonValidateWkbFunction();
+  static CreateScalarFunctionInfo GetPolygonWkbToCoveringFunction();
+  static CreateScalarFunctionInfo GetPolygonWkbContainsPointFunction();
+  static unique_ptr<CreateMacroInfo> GetPointsInPolygonsMacro();
+
+  // Sets
+  static CreateScalarFunctionInfo GetCellsToSetFunction();
+  static CreateScalarFunctionInfo GetSetToCellsFunction();
+  static CreateScalarFunctionInfo GetSetSizeFunction();
+  static CreateScalarFunctionInfo GetSetContainsFunction();
+  static CreateScalarFunctionInfo GetSetIntersectionFunction();
+  static CreateScalarFunctionInfo GetSetUnionFunction();
+  static CreateScalarFunctionInfo GetSetDifferenceFunction();
+  static AggregateFunctionSet GetSetAggFunction();
 
   static void AddAliases(vector<string> names, CreateScalarFunctionInfo fun,
                          vector<CreateScalarFunctionInfo> &functions) {
@@ -212,6 +329,10 @@ private:
       functions.push_back(fun);
     }
   }
+
+  // Stats
+  static TableFunctionSet GetStatsFunction();
+  static TableFunctionSet GetStatsResetFunction();
 };
 
 } // namespace duckdb
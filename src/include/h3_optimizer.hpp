@@ -0,0 +1,24 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// h3_optimizer.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+
+// Rewrites filters on the parent of a cell column, such as
+// h3_cell_to_parent(cell, 5) = x, to also bound the column itself. The bounds
+// are plain comparisons, which filter pushdown turns into table filters, so
+// the scan can skip row groups by their min/max statistics.
+class H3Optimizer {
+public:
+  static void Register(DBConfig &config);
+};
+
+} // namespace duckdb
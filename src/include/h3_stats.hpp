@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// h3_stats.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+// Per function execution counters, reported by h3_stats(). Collection is
+// turned on per connection by the h3_stats_enabled setting, which is read
+// when a query binds the function: a query bound while it is off runs the
+// plain kernel. The counters themselves are shared by all connections of the
+// process.
+class H3Stats {
+public:
+  // Wraps the bind of each overload of the function, so that the bound
+  // kernel is instrumented when collection is on
+  static void Instrument(CreateScalarFunctionInfo &info);
+
+  // Counts the rows of the running kernel computed by each of its named
+  // algorithms (names must be static). Does nothing while not collecting.
+  static void CountPaths(const char *const *names, const idx_t *counts,
+                         idx_t n);
+
+  // Set while an instrumented kernel runs on this thread
+  static thread_local bool collecting;
+  // Time the running kernel spent writing its results
+  static thread_local idx_t materializeNanos;
+};
+
+// Times the writing of LIST and VARCHAR results by the running kernel, which
+// h3_stats() reports apart from the rest of its time (in the H3 core). Cells
+// that the core writes straight into a list count as core time. While not
+// collecting, this is one branch.
+class H3StatsMaterialize {
+public:
+  H3StatsMaterialize() : active(H3Stats::collecting) {
+    if (active) {
+      start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~H3StatsMaterialize() {
+    if (active) {
+      H3Stats::materializeNanos +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count();
+    }
+  }
+
+private:
+  bool active;
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace duckdb
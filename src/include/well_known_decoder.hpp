@@ -1,4 +1,3 @@
-
 #pragma once
 
 #include <h3api.h>
@@ -6,16 +5,110 @@
 
 namespace duckdb {
 
-void DecodeWkbPolygon(
-    string_t input, GeoPolygon &polygon,
-    duckdb::shared_ptr<std::vector<LatLng>> &outerVerts,
-    std::vector<GeoLoop> &holes,
-    std::vector<duckdb::shared_ptr<std::vector<LatLng>>> &holesVerts);
-
-void DecodeWktPolygon(
-    string_t input, GeoPolygon &polygon,
-    duckdb::shared_ptr<std::vector<LatLng>> &outerVerts,
-    std::vector<GeoLoop> &holes,
-    std::vector<duckdb::shared_ptr<std::vector<LatLng>>> &holesVerts);
+// Why a polygon could not be decoded
+enum class PolygonDecodeError : uint8_t {
+  NONE,
+  WKB_TRUNCATED,
+  WKB_BIG_ENDIAN,
+  WKB_NOT_POLYGON,
+  WKT_NOT_POLYGON,
+  WKT_EXPECTED_BODY,
+  WKT_EXPECTED_LOOP,
+  WKT_INVALID_NUMBER,
+  WKT_EXPECTED_HOLE,
+  WKT_EXPECTED_END,
+  WKT_EXPECTED_PART_END,
+  NON_FINITE_COORDINATE,
+  TOO_DEEP
+};
+
+// Deepest nesting of GEOMETRYCOLLECTION and MULTIPOLYGON parts the decoders
+// read, which bounds their recursion
+static constexpr idx_t MAX_GEOMETRY_DEPTH = 32;
+
+// Result of decoding a polygon. The decoders do not throw; invalid input is
+// reported here along with the range of the input [position, end) it was
+// detected at.
+struct PolygonDecodeStatus {
+  PolygonDecodeError error = PolygonDecodeError::NONE;
+  size_t position = 0;
+  size_t end = 0;
+
+  static PolygonDecodeStatus Error(PolygonDecodeError error, size_t position,
+                                   size_t end) {
+    PolygonDecodeStatus status;
+    status.error = error;
+    status.position = position;
+    status.end = end;
+    return status;
+  }
+
+  bool Ok() const { return error == PolygonDecodeError::NONE; }
+
+  // WKT that is not a polygon geometry, or whose tag is not followed by
+  // loops. The non-TRY functions give an empty list for it, rather than
+  // throwing.
+  bool NotPolygon() const {
+    return error == PolygonDecodeError::WKT_NOT_POLYGON ||
+           error == PolygonDecodeError::WKT_EXPECTED_BODY;
+  }
+
+  // E_LATLNG_DOMAIN for non-finite coordinates, E_FAILED for other invalid
+  // input, and E_SUCCESS otherwise
+  H3Error Code() const;
+
+  string Message() const;
+
+  // Throws an InvalidInputException with the message, if not Ok()
+  void Check() const;
+};
+
+// Polygons decoded from WKB or WKT, and the buffers their loops point into.
+// A POLYGON decodes to one polygon, and a MULTIPOLYGON or GEOMETRYCOLLECTION
+// to one per non-empty part. Buffers are kept by Clear(), so decoding into
+// the same DecodedPolygons again does not allocate.
+class DecodedPolygons {
+public:
+  std::vector<GeoPolygon> polygons;
+
+  void Clear() {
+    polygons.clear();
+    usedLoops = 0;
+    usedHoles = 0;
+  }
+
+  // An empty vertex buffer. The reference is valid until the next call.
+  std::vector<LatLng> &NewLoop() {
+    if (usedLoops == loops.size()) {
+      loops.emplace_back();
+    }
+    auto &loop = loops[usedLoops++];
+    loop.clear();
+    return loop;
+  }
+
+  // An empty hole array. The reference is valid until the next call.
+  std::vector<GeoLoop> &NewHoles() {
+    if (usedHoles == holes.size()) {
+      holes.emplace_back();
+    }
+    auto &result = holes[usedHoles++];
+    result.clear();
+    return result;
+  }
+
+private:
+  // Moving the outer vectors keeps the inner buffers in place
+  std::vector<std::vector<LatLng>> loops;
+  size_t usedLoops = 0;
+  std::vector<std::vector<GeoLoop>> holes;
+  size_t usedHoles = 0;
+};
+
+// Decode POLYGON, MULTIPOLYGON or GEOMETRYCOLLECTION (of those) input,
+// appending to the polygons
+PolygonDecodeStatus DecodeWkbPolygon(string_t input, DecodedPolygons &out);
+
+PolygonDecodeStatus DecodeWktPolygon(string_t input, DecodedPolygons &out);
 
 } // namespace duckdb
@@ -1,118 +1,310 @@
-
 #include "well_known_decoder.hpp"
 #include "h3_functions.hpp"
 
+#include "duckdb/common/operator/cast_operators.hpp"
+
+#include <cmath>
+#include <cstring>
+
 namespace duckdb {
 
-template <typename T> static T ReadWkb(string_t input, size_t &inputIdx) {
+H3Error PolygonDecodeStatus::Code() const {
+  switch (error) {
+  case PolygonDecodeError::NONE:
+    return E_SUCCESS;
+  case PolygonDecodeError::NON_FINITE_COORDINATE:
+    return E_LATLNG_DOMAIN;
+  default:
+    return E_FAILED;
+  }
+}
+
+string PolygonDecodeStatus::Message() const {
+  switch (error) {
+  case PolygonDecodeError::NONE:
+    return "";
+  case PolygonDecodeError::WKB_TRUNCATED:
+    return StringUtil::Format("Invalid WKB: failed to read %lu bytes at %lu",
+                              end - position, position);
+  case PolygonDecodeError::WKB_BIG_ENDIAN:
+    return StringUtil::Format("Invalid WKB: expected little endian at %lu",
+                              position);
+  case PolygonDecodeError::WKB_NOT_POLYGON:
+    return StringUtil::Format("Invalid WKB: expected polygon at %lu",
+                              position);
+  case PolygonDecodeError::WKT_NOT_POLYGON:
+    return StringUtil::Format(
+        "Invalid WKT: expected POLYGON, MULTIPOLYGON or GEOMETRYCOLLECTION at "
+        "pos %lu",
+        position);
+  case PolygonDecodeError::WKT_EXPECTED_BODY:
+    return StringUtil::Format("Invalid WKT: expected ( or EMPTY at pos %lu",
+                              position);
+  case PolygonDecodeError::WKT_EXPECTED_LOOP:
+    return StringUtil::Format("Expected ( at pos %lu", position);
+  case PolygonDecodeError::WKT_INVALID_NUMBER:
+    return StringUtil::Format("Invalid number around %lu, %lu", position,
+                              end);
+  case PolygonDecodeError::WKT_EXPECTED_HOLE:
+    return StringUtil::Format(
+        "Invalid WKT: expected a hole loop '(' after ',' at pos %lu",
+        position);
+  case PolygonDecodeError::WKT_EXPECTED_END:
+    return StringUtil::Format(
+        "Invalid WKT: expected a hole loop ',' or final ')' at pos %lu",
+        position);
+  case PolygonDecodeError::WKT_EXPECTED_PART_END:
+    return StringUtil::Format(
+        "Invalid WKT: expected a part ',' or final ')' at pos %lu", position);
+  case PolygonDecodeError::NON_FINITE_COORDINATE:
+    return StringUtil::Format("Invalid coordinate: not finite at %lu",
+                              position);
+  case PolygonDecodeError::TOO_DEEP:
+    return StringUtil::Format(
+        "Invalid geometry: parts nested more than %lu deep at %lu",
+        MAX_GEOMETRY_DEPTH, position);
+  }
+  return "";
+}
+
+void PolygonDecodeStatus::Check() const {
+  if (!Ok()) {
+    throw InvalidInputException(Message());
+  }
+}
+
+template <typename T>
+static bool ReadWkb(string_t input, size_t &inputIdx, T &out,
+                    PolygonDecodeStatus &status) {
   if (inputIdx + sizeof(T) > input.GetSize()) {
-    throw InvalidInputException(StringUtil::Format(
-        "Invalid WKB: failed to read %lu bytes at %lu", sizeof(T), inputIdx));
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::WKB_TRUNCATED,
+                                        inputIdx, inputIdx + sizeof(T));
+    return false;
   }
 
-  T *resultPtr = (T *)((uint8_t *)input.GetData() + inputIdx);
+  memcpy(&out, input.GetData() + inputIdx, sizeof(T));
   inputIdx += sizeof(T);
-  return *resultPtr;
+  return true;
 }
 
-void DecodeWkbGeoLoop(string_t input, size_t &inputIdx,
-                      duckdb::shared_ptr<std::vector<LatLng>> &verts,
-                      GeoLoop &loop) {
-  uint32_t numVerts = ReadWkb<uint32_t>(input, inputIdx);
+// Reads a loop of vertices of the given number of ordinates, of which only
+// the first two (x and y) are kept.
+static PolygonDecodeStatus DecodeWkbGeoLoop(string_t input, size_t &inputIdx,
+                                            uint32_t ordinates,
+                                            std::vector<LatLng> &verts,
+                                            GeoLoop &loop) {
+  PolygonDecodeStatus status;
+  uint32_t numVerts;
+  if (!ReadWkb<uint32_t>(input, inputIdx, numVerts, status)) {
+    return status;
+  }
+
+  // Check the whole loop is present before reserving space for it
+  size_t loopSize = (size_t)numVerts * ordinates * sizeof(double);
+  if (inputIdx + loopSize > input.GetSize()) {
+    return PolygonDecodeStatus::Error(PolygonDecodeError::WKB_TRUNCATED,
+                                      inputIdx, inputIdx + loopSize);
+  }
+  verts.reserve(numVerts);
 
   for (uint32_t vertIdx = 0; vertIdx < numVerts; vertIdx++) {
-    double lng = ReadWkb<double>(input, inputIdx);
-    double lat = ReadWkb<double>(input, inputIdx);
+    size_t vertIdxStart = inputIdx;
+    double lng, lat;
+    ReadWkb<double>(input, inputIdx, lng, status);
+    ReadWkb<double>(input, inputIdx, lat, status);
+    inputIdx += (ordinates - 2) * sizeof(double);
+    if (!std::isfinite(lng) || !std::isfinite(lat)) {
+      return PolygonDecodeStatus::Error(
+          PolygonDecodeError::NON_FINITE_COORDINATE, vertIdxStart, inputIdx);
+    }
 
     LatLng ll = {.lat = degsToRads(lat), .lng = degsToRads(lng)};
 
-    verts->push_back(ll);
+    verts.push_back(ll);
   }
 
   loop.numVerts = numVerts;
-  loop.verts = verts->data();
+  loop.verts = verts.data();
+  return status;
 }
 
-void DecodeWkbPolygon(
-    string_t input, GeoPolygon &polygon,
-    duckdb::shared_ptr<std::vector<LatLng>> &outerVerts,
-    std::vector<GeoLoop> &holes,
-    std::vector<duckdb::shared_ptr<std::vector<LatLng>>> &holesVerts) {
-  size_t strIndex = 0;
-
-  uint8_t orderMark = ReadWkb<uint8_t>(input, strIndex);
-
-  if (orderMark != 0x01) {
-    throw InvalidInputException(StringUtil::Format(
-        "Invalid WKB: expected little endian at %lu", strIndex));
+static PolygonDecodeStatus DecodeWkbPolygonRings(string_t input,
+                                                 size_t &strIndex,
+                                                 uint32_t ordinates,
+                                                 DecodedPolygons &out) {
+  PolygonDecodeStatus status;
+  uint32_t loopCount;
+  if (!ReadWkb<uint32_t>(input, strIndex, loopCount, status)) {
+    return status;
   }
-
-  uint32_t type = ReadWkb<uint32_t>(input, strIndex);
-
-  if (type == 0) {
-    return; // EMPTY
-  }
-  if (type != 3) {
-    throw InvalidInputException(
-        StringUtil::Format("Invalid WKB: expected polygon at %lu", strIndex));
-  }
-
-  uint32_t loopCount = ReadWkb<uint32_t>(input, strIndex);
   if (loopCount == 0) {
-    return; // Empty
+    return status; // Empty
   }
 
-  DecodeWkbGeoLoop(input, strIndex, outerVerts, polygon.geoloop);
+  GeoPolygon polygon = {0};
+  status = DecodeWkbGeoLoop(input, strIndex, ordinates, out.NewLoop(),
+                            polygon.geoloop);
+  if (!status.Ok()) {
+    return status;
+  }
 
   if (loopCount > 1) {
+    auto &holes = out.NewHoles();
     for (uint32_t loopIdx = 1; loopIdx < loopCount; loopIdx++) {
       GeoLoop hole;
-      auto verts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-      DecodeWkbGeoLoop(input, strIndex, verts, hole);
+      status =
+          DecodeWkbGeoLoop(input, strIndex, ordinates, out.NewLoop(), hole);
+      if (!status.Ok()) {
+        return status;
+      }
       holes.push_back(hole);
-      holesVerts.push_back(verts);
     }
 
     polygon.numHoles = holes.size();
     polygon.holes = holes.data();
   }
+  out.polygons.push_back(polygon);
+  return status;
+}
+
+static const uint32_t WKB_POLYGON = 3;
+static const uint32_t WKB_MULTIPOLYGON = 6;
+static const uint32_t WKB_GEOMETRYCOLLECTION = 7;
+
+// Decodes one geometry, with its header. Parts of a MULTIPOLYGON must be
+// polygons, while a GEOMETRYCOLLECTION may nest any of the three.
+static PolygonDecodeStatus DecodeWkbGeometry(string_t input, size_t &strIndex,
+                                             uint32_t parentType, idx_t depth,
+                                             DecodedPolygons &out) {
+  PolygonDecodeStatus status;
+  if (depth > MAX_GEOMETRY_DEPTH) {
+    return PolygonDecodeStatus::Error(PolygonDecodeError::TOO_DEEP, strIndex,
+                                      strIndex);
+  }
+
+  uint8_t orderMark;
+  if (!ReadWkb<uint8_t>(input, strIndex, orderMark, status)) {
+    return status;
+  }
+
+  if (orderMark != 0x01) {
+    return PolygonDecodeStatus::Error(PolygonDecodeError::WKB_BIG_ENDIAN,
+                                      strIndex, strIndex);
+  }
+
+  uint32_t type;
+  if (!ReadWkb<uint32_t>(input, strIndex, type, status)) {
+    return status;
+  }
+
+  if (type == 0 && parentType == 0) {
+    return status; // EMPTY
+  }
+  // ISO WKB types with Z (1000+), M (2000+) or both (3000+). The extra
+  // ordinates are skipped.
+  uint32_t baseType = type % 1000;
+  uint32_t ordinates = 2;
+  if (type >= 1000 && type < 3000) {
+    ordinates = 3;
+  } else if (type >= 3000 && type < 4000) {
+    ordinates = 4;
+  } else if (type >= 4000) {
+    baseType = 0;
+  }
+
+  bool allowed = baseType == WKB_POLYGON;
+  if (parentType != WKB_MULTIPOLYGON) {
+    allowed = allowed || baseType == WKB_MULTIPOLYGON ||
+              baseType == WKB_GEOMETRYCOLLECTION;
+  }
+  if (!allowed) {
+    return PolygonDecodeStatus::Error(PolygonDecodeError::WKB_NOT_POLYGON,
+                                      strIndex, strIndex);
+  }
+
+  if (baseType == WKB_POLYGON) {
+    return DecodeWkbPolygonRings(input, strIndex, ordinates, out);
+  }
+
+  uint32_t partCount;
+  if (!ReadWkb<uint32_t>(input, strIndex, partCount, status)) {
+    return status;
+  }
+  for (uint32_t partIdx = 0; partIdx < partCount; partIdx++) {
+    status = DecodeWkbGeometry(input, strIndex, baseType, depth + 1, out);
+    if (!status.Ok()) {
+      return status;
+    }
+  }
+  return status;
+}
+
+PolygonDecodeStatus DecodeWkbPolygon(string_t input, DecodedPolygons &out) {
+  size_t strIndex = 0;
+  return DecodeWkbGeometry(input, strIndex, 0, 0, out);
 }
 
 // *** WKT ***
 
 static const std::string POLYGON = "POLYGON";
+static const std::string MULTIPOLYGON = "MULTIPOLYGON";
+static const std::string GEOMETRYCOLLECTION = "GEOMETRYCOLLECTION";
 static const std::string EMPTY = "EMPTY";
 
-static size_t WktWhitespace(const std::string &str, size_t offset) {
+// The WKT input, read in place. Reading past the end gives '\0'.
+struct WktInput {
+  explicit WktInput(string_t input)
+      : data(input.GetData()), size(input.GetSize()) {}
+
+  char operator[](size_t offset) const {
+    return offset < size ? data[offset] : '\0';
+  }
+
+  bool StartsWith(const std::string &token, size_t offset) const {
+    return offset + token.size() <= size &&
+           memcmp(data + offset, token.data(), token.size()) == 0;
+  }
+
+  const char *data;
+  size_t size;
+};
+
+static size_t WktWhitespace(const WktInput &str, size_t offset) {
   while (str[offset] == ' ') {
     offset++;
   }
   return offset;
 }
 
-static size_t ReadWktNumber(const std::string &str, size_t offset,
-                            double &num) {
+static size_t ReadWktNumber(const WktInput &str, size_t offset, double &num,
+                            PolygonDecodeStatus &status) {
   size_t start = offset;
-  while (str[offset] != ' ' && str[offset] != ')' && str[offset] != ',') {
+  while (str[offset] != ' ' && str[offset] != ')' && str[offset] != ',' &&
+         str[offset] != '\0') {
     offset++;
   }
-  std::string part = str.substr(start, offset - start);
 
-  try {
-    num = std::stod(part);
-    return offset;
-  } catch (std::invalid_argument const &ex) {
-    throw InvalidInputException(
-        StringUtil::Format("Invalid number around %lu, %lu", start, offset));
+  // The number is parsed in place: the input is not null terminated
+  if (offset == start ||
+      !TryCast::Operation(
+          string_t(str.data + start, static_cast<uint32_t>(offset - start)),
+          num)) {
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::WKT_INVALID_NUMBER,
+                                        start, offset);
+  } else if (!std::isfinite(num)) {
+    status = PolygonDecodeStatus::Error(
+        PolygonDecodeError::NON_FINITE_COORDINATE, start, offset);
   }
+  return offset;
 }
 
-static size_t ReadWktGeoLoop(const std::string &str, size_t offset,
-                             duckdb::shared_ptr<std::vector<LatLng>> verts,
-                             GeoLoop &loop) {
+static size_t ReadWktGeoLoop(const WktInput &str, size_t offset,
+                             std::vector<LatLng> &verts, GeoLoop &loop,
+                             PolygonDecodeStatus &status) {
   if (str[offset] != '(') {
-    throw InvalidInputException(
-        StringUtil::Format("Expected ( at pos %lu", offset));
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::WKT_EXPECTED_LOOP,
+                                        offset, offset);
+    return offset;
   }
 
   offset++;
@@ -120,11 +312,17 @@ static size_t ReadWktGeoLoop(const std::string &str, size_t offset,
 
   while (str[offset] != ')') {
     double x, y;
-    offset = ReadWktNumber(str, offset, x);
+    offset = ReadWktNumber(str, offset, x, status);
+    if (!status.Ok()) {
+      return offset;
+    }
     offset = WktWhitespace(str, offset);
-    offset = ReadWktNumber(str, offset, y);
+    offset = ReadWktNumber(str, offset, y, status);
+    if (!status.Ok()) {
+      return offset;
+    }
     offset = WktWhitespace(str, offset);
-    verts->push_back({.lat = degsToRads(y), .lng = degsToRads(x)});
+    verts.push_back({.lat = degsToRads(y), .lng = degsToRads(x)});
 
     if (str[offset] == ',') {
       offset++;
@@ -134,60 +332,133 @@ static size_t ReadWktGeoLoop(const std::string &str, size_t offset,
   // Consume the )
   offset++;
 
-  loop.numVerts = verts->size();
-  loop.verts = verts->data();
+  loop.numVerts = verts.size();
+  loop.verts = verts.data();
 
   offset = WktWhitespace(str, offset);
   return offset;
 }
 
-void DecodeWktPolygon(
-    string_t input, GeoPolygon &polygon,
-    duckdb::shared_ptr<std::vector<LatLng>> &outerVerts,
-    std::vector<GeoLoop> &holes,
-    std::vector<duckdb::shared_ptr<std::vector<LatLng>>> &holesVerts) {
-  std::string str = input.GetString();
-  if (str.rfind(POLYGON, 0) != 0) {
-    return;
-  }
-
-  size_t strIndex = POLYGON.length();
-  strIndex = WktWhitespace(str, strIndex);
-
-  if (str.rfind(EMPTY, strIndex) == strIndex) {
-    return;
-  }
-
-  if (str[strIndex] == '(') {
-    strIndex++;
-    strIndex = WktWhitespace(str, strIndex);
-
-    strIndex = ReadWktGeoLoop(str, strIndex, outerVerts, polygon.geoloop);
-
-    while (strIndex < str.length() && str[strIndex] == ',') {
-      strIndex++;
-      strIndex = WktWhitespace(str, strIndex);
-      if (str[strIndex] == '(') {
-        GeoLoop hole;
-        auto verts = duckdb::make_shared_ptr<std::vector<LatLng>>();
-        strIndex = ReadWktGeoLoop(str, strIndex, verts, hole);
-        holes.push_back(hole);
-        holesVerts.push_back(verts);
-      } else {
-        throw InvalidInputException(StringUtil::Format(
-            "Invalid WKT: expected a hole loop '(' after ',' at pos %lu",
-            strIndex));
-      }
+// Reads the loops of a polygon, "((...), (...))", up to and including the
+// final ')'
+static size_t ReadWktPolygonLoops(const WktInput &str, size_t offset,
+                                  DecodedPolygons &out,
+                                  PolygonDecodeStatus &status) {
+  if (str[offset] != '(') {
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::WKT_EXPECTED_LOOP,
+                                        offset, offset);
+    return offset;
+  }
+  offset++;
+  offset = WktWhitespace(str, offset);
+
+  GeoPolygon polygon = {0};
+  offset = ReadWktGeoLoop(str, offset, out.NewLoop(), polygon.geoloop, status);
+  if (!status.Ok()) {
+    return offset;
+  }
+
+  std::vector<GeoLoop> *holes = nullptr;
+  while (str[offset] == ',') {
+    offset++;
+    offset = WktWhitespace(str, offset);
+    if (str[offset] != '(') {
+      status = PolygonDecodeStatus::Error(
+          PolygonDecodeError::WKT_EXPECTED_HOLE, offset, offset);
+      return offset;
+    }
+    if (!holes) {
+      holes = &out.NewHoles();
+    }
+    GeoLoop hole;
+    offset = ReadWktGeoLoop(str, offset, out.NewLoop(), hole, status);
+    if (!status.Ok()) {
+      return offset;
+    }
+    holes->push_back(hole);
+  }
+  if (str[offset] != ')') {
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::WKT_EXPECTED_END,
+                                        offset, offset);
+    return offset;
+  }
+  offset++;
+
+  if (holes) {
+    polygon.numHoles = holes->size();
+    polygon.holes = holes->data();
+  }
+  out.polygons.push_back(polygon);
+  return WktWhitespace(str, offset);
+}
+
+// Reads a tagged geometry. Parts of a MULTIPOLYGON are untagged polygon
+// loops, while a GEOMETRYCOLLECTION nests tagged geometries.
+static size_t ReadWktGeometry(const WktInput &str, size_t offset, idx_t depth,
+                              DecodedPolygons &out,
+                              PolygonDecodeStatus &status) {
+  if (depth > MAX_GEOMETRY_DEPTH) {
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::TOO_DEEP, offset,
+                                        offset);
+    return offset;
+  }
+  const std::string *tag;
+  if (str.StartsWith(POLYGON, offset)) {
+    tag = &POLYGON;
+  } else if (str.StartsWith(MULTIPOLYGON, offset)) {
+    tag = &MULTIPOLYGON;
+  } else if (str.StartsWith(GEOMETRYCOLLECTION, offset)) {
+    tag = &GEOMETRYCOLLECTION;
+  } else {
+    status = PolygonDecodeStatus::Error(PolygonDecodeError::WKT_NOT_POLYGON,
+                                        offset, offset);
+    return offset;
+  }
+  offset = WktWhitespace(str, offset + tag->length());
+
+  // A bare tag, with nothing after it, is empty like EMPTY
+  if (offset >= str.size) {
+    return offset;
+  }
+  if (str.StartsWith(EMPTY, offset)) {
+    return WktWhitespace(str, offset + EMPTY.length());
+  }
+  if (str[offset] != '(') {
+    status = PolygonDecodeStatus::Error(
+        depth == 0 ? PolygonDecodeError::WKT_EXPECTED_BODY
+                   : PolygonDecodeError::WKT_EXPECTED_LOOP,
+        offset, offset);
+    return offset;
+  }
+  if (tag == &POLYGON) {
+    return ReadWktPolygonLoops(str, offset, out, status);
+  }
+
+  do {
+    offset = WktWhitespace(str, offset + 1);
+    if (tag == &MULTIPOLYGON) {
+      offset = ReadWktPolygonLoops(str, offset, out, status);
+    } else {
+      offset = ReadWktGeometry(str, offset, depth + 1, out, status);
     }
-    if (str[strIndex] != ')') {
-      throw InvalidInputException(StringUtil::Format(
-          "Invalid WKT: expected a hole loop ',' or final ')' at pos %lu",
-          strIndex));
+    if (!status.Ok()) {
+      return offset;
     }
+  } while (str[offset] == ',');
 
-    polygon.numHoles = holes.size();
-    polygon.holes = holes.data();
+  if (str[offset] != ')') {
+    status = PolygonDecodeStatus::Error(
+        PolygonDecodeError::WKT_EXPECTED_PART_END, offset, offset);
+    return offset;
   }
+  return WktWhitespace(str, offset + 1);
+}
+
+PolygonDecodeStatus DecodeWktPolygon(string_t input, DecodedPolygons &out) {
+  PolygonDecodeStatus status;
+  WktInput str(input);
+  ReadWktGeometry(str, 0, 0, out, status);
+  return status;
 }
 
 } // namespace duckdb